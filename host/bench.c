@@ -0,0 +1,299 @@
+/*
+ * Simulated-day benchmark: replays a day and a week of minute ticks, battery
+ * and Bluetooth events through the real watchface and reports the work done
+ * per wake-up, as counted by the host Pebble stub.
+ *
+ *   bench [--heap-budget=BYTES] [days...]      (default: 1 7)
+ *
+ * With --heap-budget, the exit status is 1 when the heap high-water mark
+ * of any run goes over the budget. The last timeline is then replayed
+ * under each transition policy (anim_policy.h), to compare their CPU use,
+ * and a noisy hour of battery and Bluetooth events shows what reaches the
+ * screen (status_events.h). Last, the first second of a cold launch and of
+ * a relaunch on the display state it left (PERSIST_KEY_DISPLAY).
+ */
+
+#include "pebble_host.h"
+#include "anim_policy.h"
+#include "settings.h"
+
+#define MINUTE_MS (60 * 1000)
+
+// Rough CPU-active time model of the watch: each wake-up costs the event
+// dispatch and app code, each redraw the compositing and display update,
+// plus its drawn pixels. Good to compare runs, not to predict battery life.
+#define WAKEUP_US 300
+#define REDRAW_US 2000
+#define DRAWN_PIXEL_NS 50
+
+static const char *const POLICY_NAMES[ANIM_POLICY_COUNT] = { "auto", "full", "reduced", "none" };
+
+static int s_days[8] = { 1, 7 };
+static int s_scenarios = 2;
+static uint32_t s_heap_peak;
+
+static uint32_t wakeups(void) {
+  uint32_t count = 0;
+  for (int i = 0; i < HOST_EVENT_COUNT; i++) count += host_stats.events[i].count;
+  return count;
+}
+
+static double active_ms(void) {
+  return (wakeups() * WAKEUP_US + host_stats.redraws * REDRAW_US) / 1000.0 +
+         host_stats.pixels_drawn * DRAWN_PIXEL_NS / 1e6;
+}
+
+static void report(const char *name, int days) {
+  printf("== %s\n", name);
+  printf("%-10s %9s %14s %12s %12s %12s %11s %11s\n", "event", "count", "cycles", "cycles/evt", "max",
+         "dirty px/evt", "glyphs/evt", "drawn px/evt");
+  for (int i = 0; i < HOST_EVENT_COUNT; i++) {
+    HostEventStats *event = &host_stats.events[i];
+    if (!event->count) continue;
+    printf("%-10s %9u %14llu %12llu %12llu %12llu %11llu %11llu\n", host_event_names[i], event->count,
+           (unsigned long long)event->cycles, (unsigned long long)(event->cycles / event->count),
+           (unsigned long long)event->max_cycles, (unsigned long long)(event->dirty_area / event->count),
+           (unsigned long long)(event->glyphs_drawn / event->count),
+           (unsigned long long)(event->pixels_drawn / event->count));
+  }
+
+  uint32_t n = wakeups();
+  uint32_t frames = host_stats.events[HOST_EVENT_ANIMATION].count;
+  double per_day = days ? 1.0 / days : 1.0;
+  printf("wake-ups             %10u  (%.0f/day)\n", n, n * per_day);
+  printf("  without anim frames%10u  (%.0f/day)\n", n - frames, (n - frames) * per_day);
+  printf("text_layer_set_text  %10u  (%.0f/day)\n", host_stats.text_set, host_stats.text_set * per_day);
+  printf("text measured        %10u\n", host_stats.text_measured);
+  printf("layer_set_frame      %10u  (%.0f/day)\n", host_stats.frame_changes, host_stats.frame_changes * per_day);
+  printf("animations created   %10u\n", host_stats.animations_created);
+  printf("animations destroyed %10u\n", host_stats.animations_destroyed);
+  uint32_t transitions = host_stats.transitions ? host_stats.transitions : 1;
+  printf("transitions          %10u\n", host_stats.transitions);
+  printf("  frames             %10u  (%.1f/transition)\n", frames, (double)frames / transitions);
+  printf("  update callbacks   %10u  (%.1f/transition)\n", host_stats.animation_frames,
+         (double)host_stats.animation_frames / transitions);
+  printf("  handler callbacks  %10u  (%.1f/transition)\n", host_stats.animation_handlers,
+         (double)host_stats.animation_handlers / transitions);
+  printf("dirty pixels         %10llu  (%.0f/day)\n", (unsigned long long)host_stats.dirty_area,
+         host_stats.dirty_area * per_day);
+  printf("redraws              %10u  (%.0f/day)\n", host_stats.redraws, host_stats.redraws * per_day);
+  printf("  glyphs drawn       %10llu\n", (unsigned long long)host_stats.glyphs_drawn);
+  printf("  pixels drawn       %10llu\n", (unsigned long long)host_stats.pixels_drawn);
+  printf("  cycles/redraw      %10.0f\n", host_stats.redraws ? (double)host_stats.redraw_cycles / host_stats.redraws : 0.0);
+  printf("resource reads       %10u  (%u bytes)\n", host_stats.resource_reads, host_stats.resource_bytes);
+  printf("allocations          %10u  (%u bytes)\n", host_stats.allocs, host_stats.bytes_allocated);
+  printf("frees                %10u\n", host_stats.frees);
+  printf("heap in use / peak   %10u / %u bytes\n", host_stats.heap_used, host_stats.heap_peak);
+  if (host_stats.heap_peak > s_heap_peak) s_heap_peak = host_stats.heap_peak;
+  printf("vibrations           %10u\n", host_stats.vibes);
+  printf("est. CPU active      %10.0f ms  (%.0f ms/day)\n", active_ms(), active_ms() * per_day);
+  printf("\n");
+}
+
+// One battery step every 12h down to 20%, then charging back 10% every 12 min
+static BatteryChargeState s_battery = { .charge_percent = 100 };
+
+static void battery_minute(int minute) {
+  bool changed = false;
+  if (!s_battery.is_charging && minute % 720 == 719) {
+    s_battery.charge_percent -= 10;
+    s_battery.is_charging = s_battery.charge_percent <= 20;
+    s_battery.is_plugged = s_battery.is_charging;
+    changed = true;
+  } else if (s_battery.is_charging && minute % 12 == 11) {
+    s_battery.charge_percent += 10;
+    if (s_battery.charge_percent >= 100) s_battery.is_charging = s_battery.is_plugged = false;
+    changed = true;
+  }
+  if (changed) host_battery_event(s_battery);
+}
+
+static void simulate(int days) {
+  for (int minute = 0; minute < days * 24 * 60; minute++) {
+    int minute_of_day = minute % (24 * 60);
+    battery_minute(minute);
+
+    if (minute_of_day == 12 * 60 + 30) {
+      // phone left on the desk for lunch
+      host_bt_event(false);
+    } else if (minute_of_day == 13 * 60 + 15) {
+      host_bt_event(true);
+    } else if (minute_of_day == 18 * 60) {
+      // flapping connection on the way home
+      for (int i = 0; i < 3; i++) {
+        host_bt_event(false);
+        host_run_for(5 * 1000);
+        host_bt_event(true);
+        host_run_for(5 * 1000);
+      }
+      host_run_for(MINUTE_MS - 30 * 1000);
+      continue;
+    }
+    host_run_for(MINUTE_MS);
+  }
+}
+
+static void report_heap(void) {
+  printf("heap by use:\n");
+  for (int i = 0; i < HOST_ALLOC_COUNT; i++) {
+    if (host_stats.heap_by_kind[i]) printf("  %-18s %10u bytes\n", host_alloc_names[i], host_stats.heap_by_kind[i]);
+  }
+  printf("\n");
+}
+
+static const char *s_mode;
+static int s_policy;
+static uint64_t s_start_cycles;
+static uint32_t s_service_events;
+
+static void run(void) {
+  char name[64];
+
+  // The first frame is drawn by now, let the work deferred to the event
+  // loop run before reporting the startup
+  uint64_t first_frame = host_stats.first_frame_at - s_start_cycles;
+  host_run_for(1);
+  uint64_t ready = host_cycles() - s_start_cycles;
+  snprintf(name, sizeof(name), "%s: startup", s_mode);
+  report(name, 0);
+  printf("first frame          %10llu cycles\n", (unsigned long long)first_frame);
+  printf("startup done         %10llu cycles\n\n", (unsigned long long)ready);
+  report_heap();
+
+  for (int i = 0; i < s_scenarios; i++) {
+    snprintf(name, sizeof(name), "%s: %d day%s", s_mode, s_days[i], s_days[i] > 1 ? "s" : "");
+    host_stats_reset();
+    simulate(s_days[i]);
+    report(name, s_days[i]);
+  }
+}
+
+// One line per policy: the last timeline, in minute mode
+static void run_policy(void) {
+  int days = s_days[s_scenarios - 1];
+  host_stats_reset();
+  simulate(days);
+  uint32_t transitions = host_stats.transitions ? host_stats.transitions : 1;
+  printf("%-8s %11u %12.1f %10.0f %10.0f %14.0f\n", POLICY_NAMES[s_policy], host_stats.transitions,
+         (double)host_stats.events[HOST_EVENT_ANIMATION].count / transitions, (double)host_stats.redraws / days,
+         (double)host_stats.pixels_drawn / days / 1000, active_ms() / days);
+  if (host_stats.heap_peak > s_heap_peak) s_heap_peak = host_stats.heap_peak;
+}
+
+// An hour of noisy service events: the battery reported every 10 s, mostly
+// unchanged, with a gauge wobbling between two values for 10 minutes; a
+// burst of 1 s Bluetooth flaps every 10 minutes, each reconnection coming
+// with a battery report; and one real 5 minute disconnection.
+static void noisy_trace(void) {
+  BatteryChargeState battery = { .charge_percent = 60 };
+  s_service_events = 0;
+  for (int second = 0; second < 60 * 60; second += 10) {
+    if (second >= 25 * 60 && second < 35 * 60) battery.charge_percent = second / 10 % 2 ? 50 : 60;
+    else battery.charge_percent = second < 30 * 60 ? 60 : 50;
+    host_battery_event(battery);
+    s_service_events++;
+
+    if (second == 45 * 60 || second == 50 * 60) {
+      host_bt_event(second == 50 * 60);
+      s_service_events++;
+    } else if (second % (10 * 60) == 5 * 60) {
+      for (int i = 0; i < 5; i++) {
+        host_bt_event(false);
+        host_run_for(1000);
+        host_bt_event(true);
+        host_battery_event(battery);
+        host_run_for(1000);
+      }
+      s_service_events += 15;
+      continue;
+    }
+    host_run_for(10 * 1000);
+  }
+}
+
+static void run_noisy(void) {
+  host_run_for(1000);
+  host_stats_reset();
+  noisy_trace();
+  printf("== noisy service events: 1 hour\n");
+  printf("service events       %10u\n", s_service_events);
+  printf("wake-ups             %10u\n", wakeups());
+  printf("redraws              %10u\n", host_stats.redraws);
+  printf("text_layer_set_text  %10u\n", host_stats.text_set);
+  printf("text measured        %10u\n", host_stats.text_measured);
+  printf("vibrations           %10u\n", host_stats.vibes);
+  printf("est. CPU active      %10.0f ms\n\n", active_ms());
+}
+
+// The first second of a launch: the first frame, and the lines sliding in
+// unless they were restored
+static void run_launch(void) {
+  uint64_t first_frame = host_stats.first_frame_at - s_start_cycles;
+  host_run_for(1000);
+  printf("%-9s %12llu %8u %12u %10.1f\n", s_mode, (unsigned long long)first_frame, host_stats.redraws,
+         host_stats.events[HOST_EVENT_ANIMATION].count, active_ms());
+}
+
+static bool s_relaunch;
+
+static void start(bool low_wake, int policy, void (*loop)(void)) {
+  // Every run replays the timeline from Saturday 2015-03-14 00:00
+  struct tm start = { .tm_year = 115, .tm_mon = 2, .tm_mday = 14 };
+  s_battery = (BatteryChargeState) { .charge_percent = 100 };
+  persist_write_bool(PERSIST_KEY_LOW_WAKE, low_wake);
+  persist_write_int(PERSIST_KEY_ANIM_POLICY, policy);
+  // a cold start, unless relaunching on what the last run showed
+  if (!s_relaunch) persist_delete(PERSIST_KEY_DISPLAY);
+  host_clock_set(timegm(&start));
+  host_stats_reset();
+  host_set_event_loop(loop);
+  s_start_cycles = host_cycles();
+  pebble_main();
+  host_app_exit();
+}
+
+int main(int argc, char **argv) {
+  uint32_t heap_budget = 0;
+  bool days_given = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--heap-budget=", 14) == 0) {
+      heap_budget = atoi(argv[i] + 14);
+    } else {
+      if (!days_given) s_scenarios = 0;
+      days_given = true;
+      if (s_scenarios < 8) s_days[s_scenarios++] = atoi(argv[i]);
+    }
+  }
+
+  for (int low_wake = 0; low_wake <= 1; low_wake++) {
+    s_mode = low_wake ? "low-wake" : "minute";
+    start(low_wake, ANIM_POLICY_DEFAULT, run);
+  }
+
+  printf("== transition policies: %d day%s\n", s_days[s_scenarios - 1], s_days[s_scenarios - 1] > 1 ? "s" : "");
+  printf("%-8s %11s %12s %10s %10s %14s\n", "policy", "transitions", "frames/trans", "redraws/d",
+         "kpx/day", "est. active ms/d");
+  for (s_policy = 0; s_policy < ANIM_POLICY_COUNT; s_policy++) start(false, s_policy, run_policy);
+  printf("\n");
+
+  start(false, ANIM_POLICY_DEFAULT, run_noisy);
+
+  printf("== launch: first second\n");
+  printf("%-9s %12s %8s %12s %10s\n", "launch", "first frame", "redraws", "anim frames", "est. ms");
+  s_mode = "cold";
+  start(false, ANIM_POLICY_DEFAULT, run_launch);
+  s_mode = "relaunch";
+  s_relaunch = true;
+  start(false, ANIM_POLICY_DEFAULT, run_launch);
+  printf("\n");
+
+  printf("heap high-water mark: %u bytes", s_heap_peak);
+  if (heap_budget) printf(" (budget %u)", heap_budget);
+  printf("\n");
+  if (heap_budget && s_heap_peak > heap_budget) {
+    fprintf(stderr, "bench: heap high-water mark %u over budget %u\n", s_heap_peak, heap_budget);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * Micro-benchmark of the formatting paths used by the watchface: the
+ * mini_format() fast paths against mini_snprintf() and libc snprintf().
+ */
+
+#include "pebble_host.h"
+#include "mini_printf.h"
+
+#define ROUNDS 1000000
+
+static volatile int s_sink;
+
+#define BENCH(label, expr) do { \
+    char buffer[50]; \
+    uint64_t start = host_cycles(); \
+    for (int i = 0; i < ROUNDS; i++) { \
+      int value = i % 100; \
+      const char *word = (i & 1) ? "Mercredi" : "Mai"; \
+      (void)value; (void)word; \
+      s_sink += (expr); \
+    } \
+    printf("  %-14s %8.1f cycles/call\n", label, (double)(host_cycles() - start) / ROUNDS); \
+  } while (0)
+
+int main(void) {
+  printf("\"%%s\"\n");
+  BENCH("mini_format", mini_format(buffer, sizeof(buffer), "%s", word));
+  BENCH("mini_snprintf", mini_snprintf(buffer, sizeof(buffer), "%s", word));
+  BENCH("snprintf", snprintf(buffer, sizeof(buffer), "%s", word));
+
+  printf("\"%%d\"\n");
+  BENCH("mini_format", mini_format(buffer, sizeof(buffer), "%d", value));
+  BENCH("mini_snprintf", mini_snprintf(buffer, sizeof(buffer), "%d", value));
+  BENCH("snprintf", snprintf(buffer, sizeof(buffer), "%d", value));
+
+  printf("\"%%d%%%%\"\n");
+  BENCH("mini_format", mini_format(buffer, sizeof(buffer), "%d%%", value));
+  BENCH("mini_snprintf", mini_snprintf(buffer, sizeof(buffer), "%d%%", value));
+  BENCH("snprintf", snprintf(buffer, sizeof(buffer), "%d%%", value));
+  return 0;
+}
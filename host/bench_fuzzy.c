@@ -0,0 +1,44 @@
+/*
+ * Micro-benchmark of the fuzzy time lookup of every locale, over all the
+ * 1440 minutes of a day.
+ */
+
+#include "pebble_host.h"
+#include "french_time.h"
+
+#define DAYS 1000
+
+static const char *const LOCALE_NAMES[LOCALE_COUNT] = { "fr", "en", "de" };
+
+static volatile int s_sink;
+
+#define BENCH(label, expr, result) do { \
+    char line1[LINE_BUFFER_SIZE], line2[LINE_BUFFER_SIZE], line3[LINE_BUFFER_SIZE]; \
+    const char *str1, *str2, *str3; \
+    struct tm t = { .tm_mday = 14, .tm_mon = 2, .tm_year = 115 }; \
+    (void)line1; (void)line2; (void)line3; (void)str1; (void)str2; (void)str3; \
+    uint64_t start = host_cycles(); \
+    for (int day = 0; day < DAYS; day++) { \
+      for (int minute = 0; minute < 24 * 60; minute++) { \
+        t.tm_hour = minute / 60; \
+        t.tm_min = minute % 60; \
+        expr; \
+        s_sink += (result); \
+      } \
+    } \
+    printf("  %-18s %8.1f cycles/minute\n", label, (double)(host_cycles() - start) / (DAYS * 24 * 60)); \
+  } while (0)
+
+int main(void) {
+  for (int locale = 0; locale < LOCALE_COUNT; locale++) {
+    if (!fuzzy_locale_load(locale)) {
+      fprintf(stderr, "bench_fuzzy: cannot load locale %s\n", LOCALE_NAMES[locale]);
+      return 1;
+    }
+    printf("%s\n", LOCALE_NAMES[locale]);
+    BENCH("fuzzy_time_lookup", fuzzy_time_lookup(&t, &str1, &str2, &str3), str1[0]);
+    BENCH("fuzzy_time", fuzzy_time(&t, line1, line2, line3), line1[0]);
+  }
+  fuzzy_locale_unload();
+  return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Size of a Pebble font resource, with every glyph of the TTF and with only
+ * the characters the face draws (see tools/font_charset.py).
+ *
+ * The sizes follow the layout of the SDK's font resources: an 8 byte
+ * header, a 255 entry hash table, 6 bytes per glyph in the offset tables,
+ * then per glyph 5 bytes of metrics and the 1-bit bitmap padded to 32 bits.
+ * Glyphs are rendered with FreeType at the pixel height of the resource.
+ *
+ * usage: font_report FONT.ttf CHARS_FILE SIZE...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#define FONT_HEADER_SIZE 8
+#define FONT_HASH_TABLE_SIZE (255 * 4)
+#define FONT_OFFSET_ENTRY_SIZE 6
+#define FONT_GLYPH_HEADER_SIZE 5
+
+// Always part of a font resource, drawn for codepoints it does not have
+#define WILDCARD_CODEPOINT 0x25AF
+
+typedef struct {
+  unsigned glyphs;
+  unsigned bytes;
+} FontSize;
+
+static void add_glyph(FT_Face face, FT_ULong codepoint, FontSize *size) {
+  FT_UInt index = FT_Get_Char_Index(face, codepoint);
+  unsigned bits = 0;
+  if (FT_Load_Glyph(face, index, FT_LOAD_RENDER | FT_LOAD_TARGET_MONO) == 0) {
+    bits = face->glyph->bitmap.width * face->glyph->bitmap.rows;
+  }
+  size->glyphs++;
+  size->bytes += FONT_OFFSET_ENTRY_SIZE + ((FONT_GLYPH_HEADER_SIZE + (bits + 31) / 32 * 4 + 3) & ~3u);
+}
+
+// Decodes one UTF-8 sequence, returns its length
+static int utf8_next(const unsigned char *s, FT_ULong *codepoint) {
+  if (s[0] < 0x80) { *codepoint = s[0]; return 1; }
+  if ((s[0] & 0xE0) == 0xC0) { *codepoint = (s[0] & 0x1F) << 6 | (s[1] & 0x3F); return 2; }
+  if ((s[0] & 0xF0) == 0xE0) { *codepoint = (s[0] & 0x0F) << 12 | (s[1] & 0x3F) << 6 | (s[2] & 0x3F); return 3; }
+  *codepoint = (s[0] & 0x07) << 18 | (s[1] & 0x3F) << 12 | (s[2] & 0x3F) << 6 | (s[3] & 0x3F);
+  return 4;
+}
+
+static FontSize full_size(FT_Face face) {
+  FontSize size = { 0, FONT_HEADER_SIZE + FONT_HASH_TABLE_SIZE };
+  FT_UInt index;
+  for (FT_ULong c = FT_Get_First_Char(face, &index); index != 0; c = FT_Get_Next_Char(face, c, &index)) {
+    if (c <= 0xFFFF) add_glyph(face, c, &size);
+  }
+  if (FT_Get_Char_Index(face, WILDCARD_CODEPOINT) == 0) add_glyph(face, WILDCARD_CODEPOINT, &size);
+  return size;
+}
+
+static FontSize subset_size(FT_Face face, const char *chars) {
+  FontSize size = { 0, FONT_HEADER_SIZE + FONT_HASH_TABLE_SIZE };
+  const unsigned char *s = (const unsigned char *)chars;
+  while (*s && *s != '\n') {
+    FT_ULong c;
+    s += utf8_next(s, &c);
+    add_glyph(face, c, &size);
+  }
+  add_glyph(face, WILDCARD_CODEPOINT, &size);
+  return size;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 4) {
+    fprintf(stderr, "usage: %s FONT.ttf CHARS_FILE SIZE...\n", argv[0]);
+    return 2;
+  }
+
+  char chars[256] = "";
+  FILE *f = fopen(argv[2], "r");
+  if (!f || !fgets(chars, sizeof(chars), f)) {
+    fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[2]);
+    return 1;
+  }
+  fclose(f);
+
+  FT_Library library;
+  FT_Face face;
+  if (FT_Init_FreeType(&library) || FT_New_Face(library, argv[1], 0, &face)) {
+    fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+    return 1;
+  }
+
+  printf("%-6s %16s %16s %8s\n", "size", "all glyphs", "subset", "saved");
+  for (int i = 3; i < argc; i++) {
+    int height = atoi(argv[i]);
+    FT_Set_Pixel_Sizes(face, 0, height);
+    FontSize full = full_size(face);
+    FontSize subset = subset_size(face, chars);
+    printf("%-6d %4u / %7u B %4u / %7u B %6.1f%%\n", height,
+           full.glyphs, full.bytes, subset.glyphs, subset.bytes,
+           100.0 * (full.bytes - subset.bytes) / full.bytes);
+  }
+
+  FT_Done_Face(face);
+  FT_Done_FreeType(library);
+  return 0;
+}
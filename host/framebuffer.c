@@ -0,0 +1,167 @@
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <png.h>
+
+#include "framebuffer.h"
+
+static FT_Library s_library;
+static FT_Face s_face;
+static uint8_t s_screen[HOST_SCREEN_H][HOST_SCREEN_W];    // 1 is white
+static uint8_t s_previous[HOST_SCREEN_H][HOST_SCREEN_W];
+static uint32_t s_frames;
+static uint32_t s_changed;
+static void (*s_frame_handler)(void);
+
+static bool in_rect(int x, int y, GRect r) {
+  return x >= r.origin.x && x < r.origin.x + r.size.w && y >= r.origin.y && y < r.origin.y + r.size.h;
+}
+
+static void begin(GColor background) {
+  memcpy(s_previous, s_screen, sizeof(s_screen));
+  memset(s_screen, background == GColorBlack ? 0 : 1, sizeof(s_screen));
+}
+
+static void fill_rect(GRect rect, GColor color) {
+  for (int y = rect.origin.y; y < rect.origin.y + rect.size.h; y++) {
+    for (int x = rect.origin.x; x < rect.origin.x + rect.size.w; x++) s_screen[y][x] = color == GColorWhite;
+  }
+}
+
+static int utf8_next(const unsigned char *s, FT_ULong *codepoint) {
+  if (s[0] < 0x80) { *codepoint = s[0]; return 1; }
+  if ((s[0] & 0xE0) == 0xC0) { *codepoint = (s[0] & 0x1F) << 6 | (s[1] & 0x3F); return 2; }
+  if ((s[0] & 0xF0) == 0xE0) { *codepoint = (s[0] & 0x0F) << 12 | (s[1] & 0x3F) << 6 | (s[2] & 0x3F); return 3; }
+  *codepoint = (s[0] & 0x07) << 18 | (s[1] & 0x3F) << 12 | (s[2] & 0x3F) << 6 | (s[3] & 0x3F);
+  return 4;
+}
+
+// One line, the baseline at the font ascender below the top of box
+static void draw_text(const char *text, GFont font, GRect box, GTextAlignment alignment, GColor color, GRect clip) {
+  if (color == GColorClear) return;
+  FT_Set_Pixel_Sizes(s_face, 0, font->size);
+
+  int width = 0;
+  FT_ULong c;
+  for (const unsigned char *p = (const unsigned char *)text; *p;) {
+    p += utf8_next(p, &c);
+    if (FT_Load_Char(s_face, c, FT_LOAD_DEFAULT) == 0) width += s_face->glyph->advance.x >> 6;
+  }
+
+  int pen = box.origin.x;
+  if (alignment == GTextAlignmentCenter) pen += (box.size.w - width) / 2;
+  else if (alignment == GTextAlignmentRight) pen += box.size.w - width;
+  int baseline = box.origin.y + (s_face->size->metrics.ascender >> 6);
+
+  for (const unsigned char *p = (const unsigned char *)text; *p;) {
+    p += utf8_next(p, &c);
+    if (FT_Load_Char(s_face, c, FT_LOAD_RENDER | FT_LOAD_TARGET_MONO)) continue;
+    FT_GlyphSlot g = s_face->glyph;
+    for (unsigned y = 0; y < g->bitmap.rows; y++) {
+      for (unsigned x = 0; x < g->bitmap.width; x++) {
+        if (!(g->bitmap.buffer[y * g->bitmap.pitch + x / 8] & (0x80 >> (x % 8)))) continue;
+        int px = pen + g->bitmap_left + x;
+        int py = baseline - g->bitmap_top + y;
+        if (in_rect(px, py, clip)) s_screen[py][px] = color == GColorWhite;
+      }
+    }
+    pen += g->advance.x >> 6;
+  }
+}
+
+// Pixel x of a row is bit x % 8 of byte x / 8, 1 is white
+static int bitmap_pixel(const GBitmap *bitmap, int x, int y) {
+  const uint8_t *row = (const uint8_t *)bitmap->addr + (bitmap->bounds.origin.y + y) * bitmap->row_size_bytes;
+  x += bitmap->bounds.origin.x;
+  return (row[x / 8] >> (x % 8)) & 1;
+}
+
+static void draw_bitmap(const GBitmap *bitmap, GRect rect, GCompOp op, GRect clip) {
+  for (int y = 0; y < rect.size.h; y++) {
+    for (int x = 0; x < rect.size.w; x++) {
+      int px = rect.origin.x + x, py = rect.origin.y + y;
+      if (!in_rect(px, py, clip)) continue;
+      int src = bitmap_pixel(bitmap, x, y);
+      uint8_t *dst = &s_screen[py][px];
+      switch (op) {
+        case GCompOpAssign: *dst = src; break;
+        case GCompOpAssignInverted: *dst = !src; break;
+        case GCompOpOr: *dst |= src; break;
+        case GCompOpAnd: *dst &= src; break;
+        case GCompOpClear: *dst &= !src; break;
+        case GCompOpSet: *dst |= !src; break;
+      }
+    }
+  }
+}
+
+static void end(void) {
+  s_changed = 0;
+  for (int y = 0; y < HOST_SCREEN_H; y++) {
+    for (int x = 0; x < HOST_SCREEN_W; x++) s_changed += s_screen[y][x] != s_previous[y][x];
+  }
+  s_frames++;
+  if (s_frame_handler) s_frame_handler();
+}
+
+// As the SDK converts PNGs: black where opaque and dark, white elsewhere
+static void decode_png(const uint8_t *data, size_t size, GBitmap *bitmap) {
+  png_image image = { .version = PNG_IMAGE_VERSION };
+  if (!png_image_begin_read_from_memory(&image, data, size)) return;
+  image.format = PNG_FORMAT_GA;
+  uint8_t *pixels = calloc(1, PNG_IMAGE_SIZE(image));
+  int w = bitmap->bounds.size.w, h = bitmap->bounds.size.h;
+  if ((int)image.width == w && (int)image.height == h && png_image_finish_read(&image, NULL, pixels, 0, NULL)) {
+    uint8_t *rows = bitmap->addr;
+    memset(rows, 0xFF, bitmap->row_size_bytes * h);
+    for (int y = 0; y < h; y++) {
+      for (int x = 0; x < w; x++) {
+        const uint8_t *ga = pixels + (y * w + x) * 2;
+        if (ga[1] >= 128 && ga[0] < 128) rows[y * bitmap->row_size_bytes + x / 8] &= ~(1 << (x % 8));
+      }
+    }
+  }
+  png_image_free(&image);
+  (free)(pixels);
+}
+
+static const HostRenderer s_renderer = { begin, fill_rect, draw_text, draw_bitmap, end, decode_png };
+
+bool framebuffer_init(const char *font_path) {
+  if (FT_Init_FreeType(&s_library)) return false;
+  if (FT_New_Face(s_library, font_path, 0, &s_face)) {
+    FT_Done_FreeType(s_library);
+    return false;
+  }
+  memset(s_screen, 1, sizeof(s_screen));
+  s_frames = s_changed = 0;
+  host_set_renderer(&s_renderer);
+  return true;
+}
+
+void framebuffer_done(void) {
+  host_set_renderer(NULL);
+  FT_Done_Face(s_face);
+  FT_Done_FreeType(s_library);
+}
+
+void framebuffer_set_frame_handler(void (*handler)(void)) {
+  s_frame_handler = handler;
+}
+
+uint32_t framebuffer_frames(void) {
+  return s_frames;
+}
+
+uint32_t framebuffer_changed(void) {
+  return s_changed;
+}
+
+bool framebuffer_write_png(const char *path) {
+  static uint8_t gray[HOST_SCREEN_H][HOST_SCREEN_W];
+  for (int y = 0; y < HOST_SCREEN_H; y++) {
+    for (int x = 0; x < HOST_SCREEN_W; x++) gray[y][x] = s_screen[y][x] ? 0xFF : 0;
+  }
+  png_image image = { .version = PNG_IMAGE_VERSION, .width = HOST_SCREEN_W, .height = HOST_SCREEN_H,
+                      .format = PNG_FORMAT_GRAY };
+  return png_image_write_to_file(&image, path, 0, gray, HOST_SCREEN_W, NULL);
+}
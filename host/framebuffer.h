@@ -0,0 +1,25 @@
+#pragma once
+
+/*
+ * Software framebuffer for the host stub: a HostRenderer that draws every
+ * redraw into a 144x168 1 bit screen, the text with FreeType, and decodes
+ * the PNG resources and writes the frames with libpng.
+ */
+
+#include "pebble_host.h"
+
+// Installs the renderer. Every text is drawn with the TrueType font at
+// font_path, at the size of its GFont: the host has no system fonts.
+bool framebuffer_init(const char *font_path);
+void framebuffer_done(void);
+
+// Called after each frame is drawn
+void framebuffer_set_frame_handler(void (*handler)(void));
+
+// Frames drawn since framebuffer_init(), and the pixels of the last one
+// that differ from the frame before
+uint32_t framebuffer_frames(void);
+uint32_t framebuffer_changed(void);
+
+// The last frame, as an 8 bit grayscale PNG
+bool framebuffer_write_png(const char *path);
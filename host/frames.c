@@ -0,0 +1,116 @@
+/*
+ * Draws the watchface into the host framebuffer (framebuffer.h) and prints
+ * the pixels each frame changes, and the frames and pixels of each line
+ * transition, e.g. to measure a redraw change or look at the slide:
+ *
+ *   frames 2015-03-14T07:58 5
+ *   frames --png=/tmp/frames --locale=de 2015-03-14T07:58 5
+ *
+ * With --png, every frame is also written to DIR/frame_NNNN.png.
+ */
+
+#define _GNU_SOURCE
+#include "pebble_host.h"
+#include "framebuffer.h"
+#include "french_time.h"
+#include "settings.h"
+
+#ifndef HOST_RESOURCES_DIR
+#define HOST_RESOURCES_DIR "resources"
+#endif
+
+static int s_minutes = 5;
+static const char *s_png_dir;
+
+// The transition being drawn, as counted by the stub
+static uint32_t s_transition;
+static uint32_t s_animation_frames;
+static uint32_t s_transition_frames;
+static uint64_t s_transition_changed;
+static uint32_t s_transition_max;
+static uint64_t s_total_changed;
+
+static void end_transition(void) {
+  if (!s_transition_frames) return;
+  printf("  transition %u: %u frames, %llu pixels changed (%llu/frame, max %u)\n", s_transition,
+         s_transition_frames, (unsigned long long)s_transition_changed,
+         (unsigned long long)(s_transition_changed / s_transition_frames), s_transition_max);
+  s_transition_frames = 0;
+  s_transition_changed = 0;
+  s_transition_max = 0;
+}
+
+static void frame_handler(void) {
+  char stamp[20];
+  uint64_t ms = host_clock_ms();
+  time_t now = ms / 1000;
+  strftime(stamp, sizeof(stamp), "%H:%M:%S", gmtime(&now));
+
+  uint32_t frames = host_stats.events[HOST_EVENT_ANIMATION].count;
+  bool animation = frames != s_animation_frames;
+  s_animation_frames = frames;
+  if (!animation || host_stats.transitions != s_transition) end_transition();
+  s_transition = host_stats.transitions;
+
+  uint32_t changed = framebuffer_changed();
+  s_total_changed += changed;
+  printf("%4u %s.%03u %-9s %6u px\n", framebuffer_frames(), stamp, (unsigned)(ms % 1000),
+         animation ? "animation" : "event", changed);
+  if (animation) {
+    s_transition_frames++;
+    s_transition_changed += changed;
+    if (changed > s_transition_max) s_transition_max = changed;
+  }
+
+  if (s_png_dir) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/frame_%04u.png", s_png_dir, framebuffer_frames());
+    if (!framebuffer_write_png(path)) fprintf(stderr, "frames: cannot write %s\n", path);
+  }
+}
+
+static void run(void) {
+  for (int i = 0; i < s_minutes; i++) host_run_for(60 * 1000);
+  end_transition();
+  uint32_t frames = framebuffer_frames();
+  printf("%u frames, %llu pixels changed (%llu/frame)\n", frames, (unsigned long long)s_total_changed,
+         (unsigned long long)(frames ? s_total_changed / frames : 0));
+}
+
+static int usage(const char *name) {
+  fprintf(stderr, "usage: %s [--png=DIR] [--locale=fr|en|de] [YYYY-MM-DDTHH:MM] [minutes]\n", name);
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  static const char *const locales[LOCALE_COUNT] = { "fr", "en", "de" };
+  struct tm start = { .tm_year = 115, .tm_mon = 2, .tm_mday = 14, .tm_hour = 7, .tm_min = 58 };
+  int arg = 1;
+
+  for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+    if (strncmp(argv[arg], "--png=", 6) == 0) {
+      s_png_dir = argv[arg] + 6;
+    } else if (strncmp(argv[arg], "--locale=", 9) == 0) {
+      // The watchface reads its locale from persistent storage
+      int locale = 0;
+      while (locale < LOCALE_COUNT && strcmp(argv[arg] + 9, locales[locale]) != 0) locale++;
+      if (locale == LOCALE_COUNT) return usage(argv[0]);
+      persist_write_int(PERSIST_KEY_LOCALE, locale);
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (arg < argc && !strptime(argv[arg++], "%Y-%m-%dT%H:%M", &start)) return usage(argv[0]);
+  if (arg < argc) s_minutes = atoi(argv[arg]);
+
+  if (!framebuffer_init(HOST_RESOURCES_DIR "/fonts/Domestic_Manners.ttf")) {
+    fprintf(stderr, "frames: cannot load the font\n");
+    return 1;
+  }
+  framebuffer_set_frame_handler(frame_handler);
+  host_clock_set(timegm(&start));
+  host_set_event_loop(run);
+  pebble_main();
+  framebuffer_done();
+  return 0;
+}
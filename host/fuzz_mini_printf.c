@@ -0,0 +1,188 @@
+/*
+ * Differential fuzzer of mini_vsnprintf() against the libc vsnprintf().
+ *
+ * Each input is decoded into a buffer size and a format of literals, %%,
+ * and up to three %c, %s, %d, %u, %x or %X conversions (the integer ones
+ * with an optional %0N width) with their arguments. mini_snprintf() must
+ * write what vsnprintf() does, truncated to the buffer, return its length
+ * and leave the byte after the buffer alone.
+ *
+ * LLVMFuzzerTestOneInput() is the libFuzzer entry point:
+ *   clang -g -fsanitize=fuzzer,address,undefined -DFUZZ_NO_MAIN -Isrc \
+ *     host/fuzz_mini_printf.c src/mini_printf.c
+ * Without FUZZ_NO_MAIN, main() runs each file given (a corpus, or an AFL
+ * input), or else a fixed number of pseudo random inputs, which is what the
+ * host build does. Prints the failures, and exits with 1 when there are any.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdarg.h>
+#include "mini_printf.h"
+
+#define MAX_CONVERSIONS 3
+#define MAX_BUFFER 48
+#define RANDOM_INPUTS 200000
+#define RANDOM_INPUT_SIZE 64
+
+typedef struct {
+  const uint8_t* data;
+  size_t size;
+} Input;
+
+typedef struct {
+  char conversion;
+  int value;
+  const char* text;
+} Arg;
+
+static const int EDGE_VALUES[] = { 0, 1, -1, 9, 10, -10, 99, 100, INT_MAX, INT_MIN, INT_MIN + 1 };
+static const char* const TEXTS[] = { "", "a", "huit h.", "moins le quart", "Samedi 14 Mars" };
+
+static long s_failures;
+
+// Next input byte, 0 once they are all read
+static uint8_t next_byte(Input* in) {
+  if (!in->size) return 0;
+  in->size--;
+  return *in->data++;
+}
+
+static int next_value(Input* in) {
+  uint8_t b = next_byte(in);
+  if (b & 1) return EDGE_VALUES[(b >> 1) % (sizeof(EDGE_VALUES) / sizeof(EDGE_VALUES[0]))];
+  uint32_t v = 0;
+  for (int i = 0; i < 4; i++) v = v << 8 | next_byte(in);
+  return (int)v;
+}
+
+// Decodes in into fmt and args, returns the number of args
+static int decode(Input* in, char* fmt, Arg* args) {
+  int n = 0;
+  int parts = next_byte(in) % 8;
+  for (int p = 0; p < parts; p++) {
+    uint8_t b = next_byte(in);
+    if (b % 10 < 4 || n == MAX_CONVERSIONS) {
+      char c = ' ' + next_byte(in) % 95;
+      *fmt++ = c;
+      if (c == '%') *fmt++ = '%';
+      continue;
+    }
+    Arg* arg = &args[n++];
+    arg->conversion = "duxXsc"[b % 6];
+    *fmt++ = '%';
+    if (arg->conversion != 's' && arg->conversion != 'c' && b & 0x80) {
+      fmt += sprintf(fmt, "0%u", next_byte(in) % 23);
+    }
+    *fmt++ = arg->conversion;
+    arg->value = arg->conversion == 'c' ? 1 + next_byte(in) % 126 : next_value(in);
+    arg->text = TEXTS[next_byte(in) % (sizeof(TEXTS) / sizeof(TEXTS[0]))];
+  }
+  *fmt = 0;
+  return n;
+}
+
+// Formats with both, returns what mini_vsnprintf() does
+static int format_both(char* mini, unsigned int mini_len, char* libc, size_t libc_len, char* fmt, ...) {
+  va_list va, vb;
+  va_start(va, fmt);
+  va_copy(vb, va);
+  int len = mini_vsnprintf(mini, mini_len, fmt, va);
+  vsnprintf(libc, libc_len, fmt, vb);
+  va_end(vb);
+  va_end(va);
+  return len;
+}
+
+// Each argument passed as the type of its conversion
+#define I(i) args[i].value
+#define S(i) args[i].text
+#define CALL(...) len = format_both(mini, size, libc, sizeof(libc), fmt, __VA_ARGS__); break
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t data_size) {
+  Input in = { data, data_size };
+  char fmt[128];
+  Arg args[MAX_CONVERSIONS];
+  unsigned int size = next_byte(&in) % MAX_BUFFER;
+  int n = decode(&in, fmt, args);
+
+  int strings = 0;
+  for (int i = 0; i < n; i++) strings |= (args[i].conversion == 's') << i;
+
+  // one byte past the buffer, to catch overflows
+  char* mini = malloc(size + 1);
+  char libc[512];
+  memset(mini, 'Z', size + 1);
+  int len = 0;
+  switch (n << 3 | strings) {
+    case 0: len = format_both(mini, size, libc, sizeof(libc), fmt); break;
+    case 010: CALL(I(0));
+    case 011: CALL(S(0));
+    case 020: CALL(I(0), I(1));
+    case 021: CALL(S(0), I(1));
+    case 022: CALL(I(0), S(1));
+    case 023: CALL(S(0), S(1));
+    case 030: CALL(I(0), I(1), I(2));
+    case 031: CALL(S(0), I(1), I(2));
+    case 032: CALL(I(0), S(1), I(2));
+    case 033: CALL(S(0), S(1), I(2));
+    case 034: CALL(I(0), I(1), S(2));
+    case 035: CALL(S(0), I(1), S(2));
+    case 036: CALL(I(0), S(1), S(2));
+    case 037: CALL(S(0), S(1), S(2));
+  }
+
+  char expected[512];
+  snprintf(expected, sizeof(expected), "%.*s", size ? (int)size - 1 : 0, libc);
+  int bad = size ? strcmp(mini, expected) != 0 || len != (int)strlen(expected) || mini[size] != 'Z'
+                 : len != 0 || mini[0] != 'Z';
+  if (bad && s_failures++ < 10) {
+    printf("fmt \"%s\" size %u: mini \"%.*s\" (%d), libc \"%s\"\n", fmt, size, (int)size, mini, len, expected);
+  }
+  free(mini);
+#ifdef FUZZ_NO_MAIN
+  if (bad) abort();
+#endif
+  return 0;
+}
+
+#ifndef FUZZ_NO_MAIN
+static int run_file(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+  uint8_t data[4096];
+  size_t size = fread(data, 1, sizeof(data), f);
+  fclose(f);
+  LLVMFuzzerTestOneInput(data, size);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  long inputs = argc > 1 ? argc - 1 : RANDOM_INPUTS;
+  for (int i = 1; i < argc; i++) {
+    if (run_file(argv[i])) return 1;
+  }
+  if (argc == 1) {
+    // xorshift64, seeded the same on every run
+    uint64_t x = 88172645463325252ull;
+    for (long i = 0; i < RANDOM_INPUTS; i++) {
+      uint8_t data[RANDOM_INPUT_SIZE];
+      for (int j = 0; j < RANDOM_INPUT_SIZE; j++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        data[j] = x >> 56;
+      }
+      LLVMFuzzerTestOneInput(data, sizeof(data));
+    }
+  }
+  printf("%ld inputs, %ld failures\n", inputs, s_failures);
+  return s_failures != 0;
+}
+#endif
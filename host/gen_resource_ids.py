@@ -0,0 +1,37 @@
+#!/usr/bin/env python
+#
+# Generates resource_ids.auto.h for the host build from appinfo.json, the
+# same way the Pebble SDK does for the watch build. The host flavour also
+# carries the file and name of each resource so pebble_host.c can read it,
+# and registers the resources of every drawing mode (tools/mode_resources.py).
+#
+# usage: python host/gen_resource_ids.py appinfo.json > resource_ids.auto.h
+
+from __future__ import print_function
+import json
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tools"))
+import mode_resources
+
+
+def main():
+  with open(sys.argv[1]) as f:
+    media = mode_resources.all_media(json.load(f)["resources"]["media"])
+
+  out = ["// Generated by host/gen_resource_ids.py, do not edit.", "#pragma once", ""]
+  for i, res in enumerate(media):
+    out.append("#define RESOURCE_ID_%s %d" % (res["name"], i + 1))
+  out.append("")
+  out.append("#define HOST_RESOURCE_COUNT %d" % len(media))
+  out.append("#define HOST_RESOURCE_TABLE { \\")
+  out.append("  { NULL, NULL, NULL }, \\")
+  for res in media:
+    out.append('  { "%s", "%s", "%s" }, \\' % (res["name"], res["type"], res["file"]))
+  out.append("}")
+  print("\n".join(out))
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,378 @@
+#pragma once
+
+/*
+ * Host (Linux) stand-in for the Pebble SDK 2 pebble.h.
+ *
+ * Only the part of the API used by the watchface is declared here. The
+ * implementation in pebble_host.c records every call and allocation in
+ * host_stats (see pebble_host.h) so the real sources in src/ can be run,
+ * measured and compared without a watch.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "resource_ids.auto.h"
+
+// Time is driven by the harness clock, not by the host wall clock
+time_t host_time(time_t *tloc);
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+struct tm *host_localtime(const time_t *timep);
+#define time(tloc) host_time(tloc)
+#define localtime(timep) host_localtime(timep)
+
+// The app heap is accounted by the harness allocator
+void *host_app_malloc(size_t size);
+void host_app_free(void *ptr);
+#define malloc(size) host_app_malloc(size)
+#define free(ptr) host_app_free(ptr)
+
+// ----------------------------------------------------------------- status
+
+typedef enum {
+  S_TRUE = 1,
+  S_FALSE = 0,
+  S_SUCCESS = 0,
+  E_ERROR = -1,
+  E_UNKNOWN = -2,
+  E_INTERNAL = -3,
+  E_INVALID_ARGUMENT = -4,
+  E_OUT_OF_MEMORY = -5,
+  E_OUT_OF_STORAGE = -6,
+  E_OUT_OF_RESOURCES = -7,
+  E_RANGE = -8,
+  E_DOES_NOT_EXIST = -9,
+  E_INVALID_OPERATION = -10,
+  E_BUSY = -11,
+  S_NO_MORE_ITEMS = 2,
+  S_NO_ACTION_REQUIRED = 3,
+} StatusCode;
+
+typedef int32_t status_t;
+
+// ---------------------------------------------------------------- logging
+
+typedef enum {
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+  APP_LOG_LEVEL_DEBUG_VERBOSE = 255,
+} AppLogLevel;
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...);
+
+#define APP_LOG(level, fmt, args...) \
+  app_log(level, __FILE__, __LINE__, fmt, ## args)
+
+// --------------------------------------------------------------- graphics
+
+typedef struct GPoint {
+  int16_t x;
+  int16_t y;
+} GPoint;
+
+typedef struct GSize {
+  int16_t w;
+  int16_t h;
+} GSize;
+
+typedef struct GRect {
+  GPoint origin;
+  GSize size;
+} GRect;
+
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GRectZero GRect(0, 0, 0, 0)
+
+typedef enum GColor {
+  GColorClear = ~0,
+  GColorBlack = 0,
+  GColorWhite = 1,
+} GColor;
+
+typedef enum {
+  GTextAlignmentLeft,
+  GTextAlignmentCenter,
+  GTextAlignmentRight,
+} GTextAlignment;
+
+typedef enum {
+  GTextOverflowModeWordWrap,
+  GTextOverflowModeTrailingEllipsis,
+  GTextOverflowModeFill,
+} GTextOverflowMode;
+
+typedef enum {
+  GAlignCenter,
+  GAlignTopLeft,
+  GAlignTopRight,
+  GAlignTop,
+  GAlignLeft,
+  GAlignBottom,
+  GAlignRight,
+  GAlignBottomRight,
+  GAlignBottomLeft,
+} GAlign;
+
+typedef enum {
+  GCompOpAssign,
+  GCompOpAssignInverted,
+  GCompOpOr,
+  GCompOpAnd,
+  GCompOpClear,
+  GCompOpSet,
+} GCompOp;
+
+typedef struct GBitmap {
+  void *addr;
+  uint16_t row_size_bytes;
+  uint16_t info_flags;
+  GRect bounds;
+} GBitmap;
+
+typedef struct FontInfo *GFont;
+typedef struct GContext GContext;
+
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_18 "RESOURCE_ID_GOTHIC_18"
+#define FONT_KEY_GOTHIC_24 "RESOURCE_ID_GOTHIC_24"
+#define FONT_KEY_GOTHIC_28 "RESOURCE_ID_GOTHIC_28"
+#define FONT_KEY_GOTHIC_28_BOLD "RESOURCE_ID_GOTHIC_28_BOLD"
+#define FONT_KEY_BITHAM_42_BOLD "RESOURCE_ID_BITHAM_42_BOLD"
+
+GFont fonts_get_system_font(const char *font_key);
+
+typedef struct ResourceEntry *ResHandle;
+
+ResHandle resource_get_handle(uint32_t resource_id);
+size_t resource_size(ResHandle h);
+size_t resource_load(ResHandle h, uint8_t *buffer, size_t max_length);
+size_t resource_load_byte_range(ResHandle h, uint32_t start_offset, uint8_t *buffer, size_t num_bytes);
+
+GFont fonts_load_custom_font(ResHandle handle);
+void fonts_unload_custom_font(GFont font);
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id);
+GBitmap *gbitmap_create_with_data(const uint8_t *data);
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base_bitmap, GRect sub_rect);
+void gbitmap_destroy(GBitmap *bitmap);
+
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_draw_text(GContext *ctx, const char *text, const GFont font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        const void *layout);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+GSize graphics_text_layout_get_content_size(const char *text, const GFont font, const GRect box,
+                                            const GTextOverflowMode overflow_mode,
+                                            const GTextAlignment alignment);
+
+// ----------------------------------------------------------------- layers
+
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef struct BitmapLayer BitmapLayer;
+typedef struct Window Window;
+
+typedef void (*LayerUpdateProc)(struct Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+void layer_destroy(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_mark_dirty(Layer *layer);
+void layer_set_frame(Layer *layer, GRect frame);
+GRect layer_get_frame(const Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_set_hidden(Layer *layer, bool hidden);
+bool layer_get_hidden(const Layer *layer);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+const char *text_layer_get_text(TextLayer *text_layer);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment);
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode);
+GSize text_layer_get_content_size(TextLayer *text_layer);
+
+BitmapLayer *bitmap_layer_create(GRect frame);
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer);
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer);
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap);
+void bitmap_layer_set_alignment(BitmapLayer *bitmap_layer, GAlign alignment);
+void bitmap_layer_set_background_color(BitmapLayer *bitmap_layer, GColor color);
+void bitmap_layer_set_compositing_mode(BitmapLayer *bitmap_layer, GCompOp mode);
+
+// ----------------------------------------------------------------- window
+
+typedef void (*WindowHandler)(struct Window *window);
+
+typedef struct WindowHandlers {
+  WindowHandler load;
+  WindowHandler appear;
+  WindowHandler disappear;
+  WindowHandler unload;
+} WindowHandlers;
+
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_background_color(Window *window, GColor background_color);
+void window_stack_push(Window *window, bool animated);
+Layer *window_get_root_layer(const Window *window);
+
+// -------------------------------------------------------------- animation
+
+#define ANIMATION_NORMALIZED_MIN 0
+#define ANIMATION_NORMALIZED_MAX 65535
+
+typedef enum {
+  AnimationCurveLinear = 0,
+  AnimationCurveEaseIn = 1,
+  AnimationCurveEaseOut = 2,
+  AnimationCurveEaseInOut = 3,
+} AnimationCurve;
+
+struct Animation;
+
+typedef void (*AnimationStartedHandler)(struct Animation *animation, void *context);
+typedef void (*AnimationStoppedHandler)(struct Animation *animation, bool finished, void *context);
+
+typedef struct AnimationHandlers {
+  AnimationStartedHandler started;
+  AnimationStoppedHandler stopped;
+} AnimationHandlers;
+
+typedef void (*AnimationSetupImplementation)(struct Animation *animation);
+typedef void (*AnimationUpdateImplementation)(struct Animation *animation, const uint32_t distance_normalized);
+typedef void (*AnimationTeardownImplementation)(struct Animation *animation);
+
+typedef struct AnimationImplementation {
+  AnimationSetupImplementation setup;
+  AnimationUpdateImplementation update;
+  AnimationTeardownImplementation teardown;
+} AnimationImplementation;
+
+typedef struct Animation {
+  const AnimationImplementation *implementation;
+  AnimationHandlers handlers;
+  void *context;
+  uint32_t abs_start_time_ms;
+  uint32_t delay_ms;
+  uint32_t duration_ms;
+  AnimationCurve curve;
+  bool is_completed;
+} Animation;
+
+typedef struct PropertyAnimation {
+  Animation animation;
+  struct {
+    union {
+      GRect grect;
+      GPoint gpoint;
+      int16_t int16;
+    } to;
+    union {
+      GRect grect;
+      GPoint gpoint;
+      int16_t int16;
+    } from;
+  } values;
+  void *subject;
+} PropertyAnimation;
+
+Animation *animation_create(void);
+void animation_destroy(Animation *animation);
+void animation_set_delay(Animation *animation, uint32_t delay_ms);
+void animation_set_duration(Animation *animation, uint32_t duration_ms);
+void animation_set_curve(Animation *animation, AnimationCurve curve);
+void animation_set_handlers(Animation *animation, AnimationHandlers callbacks, void *context);
+void animation_set_implementation(Animation *animation, const AnimationImplementation *implementation);
+void *animation_get_context(Animation *animation);
+void animation_schedule(Animation *animation);
+void animation_unschedule(Animation *animation);
+void animation_unschedule_all(void);
+bool animation_is_scheduled(Animation *animation);
+
+PropertyAnimation *property_animation_create_layer_frame(struct Layer *layer, GRect *from_frame, GRect *to_frame);
+void property_animation_destroy(PropertyAnimation *property_animation);
+
+// ----------------------------------------------------------------- timers
+
+typedef void *AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer_handle);
+
+// --------------------------------------------------------------- services
+
+typedef enum {
+  SECOND_UNIT = 1 << 0,
+  MINUTE_UNIT = 1 << 1,
+  HOUR_UNIT = 1 << 2,
+  DAY_UNIT = 1 << 3,
+  MONTH_UNIT = 1 << 4,
+  YEAR_UNIT = 1 << 5,
+} TimeUnits;
+
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+typedef struct {
+  uint8_t charge_percent;
+  bool is_charging;
+  bool is_plugged;
+} BatteryChargeState;
+
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+
+typedef void (*BluetoothConnectionHandler)(bool connected);
+
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler);
+void bluetooth_connection_service_unsubscribe(void);
+bool bluetooth_connection_service_peek(void);
+
+void vibes_short_pulse(void);
+void vibes_double_pulse(void);
+void vibes_long_pulse(void);
+
+// ---------------------------------------------------------------- persist
+
+#define PERSIST_DATA_MAX_LENGTH 256
+#define PERSIST_STRING_MAX_LENGTH PERSIST_DATA_MAX_LENGTH
+
+bool persist_exists(const uint32_t key);
+int persist_get_size(const uint32_t key);
+bool persist_read_bool(const uint32_t key);
+int32_t persist_read_int(const uint32_t key);
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size);
+int persist_read_string(const uint32_t key, char *buffer, const size_t buffer_size);
+status_t persist_write_bool(const uint32_t key, const bool value);
+status_t persist_write_int(const uint32_t key, const int32_t value);
+int persist_write_data(const uint32_t key, const void *data, const size_t size);
+int persist_write_string(const uint32_t key, const char *cstring);
+status_t persist_delete(const uint32_t key);
+
+// ------------------------------------------------------------------- misc
+
+void app_event_loop(void);
@@ -0,0 +1,1193 @@
+/*
+ * Host (Linux) implementation of the Pebble SDK subset declared in pebble.h.
+ *
+ * Nothing is drawn here: layers only keep their state, and every call that
+ * costs work on the watch (text changes, dirty marks, animations, timers,
+ * heap allocations, resource reads) is counted in host_stats. After each
+ * event that marked a layer dirty, the redraw the firmware would do is
+ * counted too, as the glyphs and pixels of the visible layers, and handed
+ * to the HostRenderer if a harness set one (see framebuffer.h).
+ */
+
+#include <stdarg.h>
+#include "pebble_host.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef HOST_RESOURCES_DIR
+#define HOST_RESOURCES_DIR "resources"
+#endif
+
+#define MAX_ANIMATIONS 32
+#define MAX_TIMERS 16
+#define MAX_PERSIST_KEYS 32
+
+HostStats host_stats;
+
+const char *const host_event_names[HOST_EVENT_COUNT] = {
+  "load", "tick", "timer", "animation", "battery", "bluetooth"
+};
+
+static uint64_t s_clock_ms;
+static struct tm s_tm;
+static void (*s_event_loop)(void);
+static Window *s_top_window;
+
+static TickHandler s_tick_handler;
+static TimeUnits s_tick_units;
+static BatteryStateHandler s_battery_handler;
+static BatteryChargeState s_battery_state = { .charge_percent = 80 };
+static BluetoothConnectionHandler s_bt_handler;
+static bool s_bt_connected = true;
+static const HostRenderer *s_renderer;
+
+// ----------------------------------------------------------------- memory
+
+const char *const host_alloc_names[HOST_ALLOC_COUNT] = {
+  "window", "layer", "text layer", "bitmap layer", "bitmap", "font", "animation", "app malloc", "other"
+};
+
+typedef union {
+  struct {
+    uint32_t size;
+    HostAllocKind kind;
+  };
+  long double align;
+} AllocHeader;
+
+void *host_alloc(size_t size, HostAllocKind kind) {
+  AllocHeader *header = calloc(1, sizeof(AllocHeader) + size);
+  header->size = size;
+  header->kind = kind;
+  host_stats.allocs++;
+  host_stats.bytes_allocated += size;
+  host_stats.heap_used += size;
+  host_stats.heap_by_kind[kind] += size;
+  if (host_stats.heap_used > host_stats.heap_peak) host_stats.heap_peak = host_stats.heap_used;
+  return header + 1;
+}
+
+void host_free(void *ptr) {
+  if (!ptr) return;
+  AllocHeader *header = (AllocHeader *)ptr - 1;
+  host_stats.frees++;
+  host_stats.heap_used -= header->size;
+  host_stats.heap_by_kind[header->kind] -= header->size;
+  (free)(header);
+}
+
+void *host_app_malloc(size_t size) {
+  return host_alloc(size, HOST_ALLOC_APP);
+}
+
+void host_app_free(void *ptr) {
+  host_free(ptr);
+}
+
+void host_stats_reset(void) {
+  HostStats heap = host_stats;
+  memset(&host_stats, 0, sizeof(host_stats));
+  host_stats.heap_used = heap.heap_used;
+  host_stats.heap_peak = heap.heap_used;
+  memcpy(host_stats.heap_by_kind, heap.heap_by_kind, sizeof(heap.heap_by_kind));
+}
+
+// ---------------------------------------------------------------- events
+
+uint64_t host_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+typedef struct {
+  uint64_t cycles;
+  uint64_t dirty_area;
+} EventMark;
+
+static bool s_needs_redraw;
+
+static void window_redraw(HostEventStats *event);
+
+static EventMark event_begin(void) {
+  return (EventMark) { host_cycles(), host_stats.dirty_area };
+}
+
+static void event_done(HostEventKind kind, EventMark start) {
+  uint64_t cycles = host_cycles() - start.cycles;
+  HostEventStats *event = &host_stats.events[kind];
+  event->count++;
+  event->cycles += cycles;
+  if (cycles > event->max_cycles) event->max_cycles = cycles;
+  event->dirty_area += host_stats.dirty_area - start.dirty_area;
+  if (s_needs_redraw) window_redraw(event);
+}
+
+// ----------------------------------------------------------------- clock
+
+time_t host_time(time_t *tloc) {
+  time_t now = (time_t)(s_clock_ms / 1000);
+  if (tloc) *tloc = now;
+  return now;
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+  uint16_t ms = s_clock_ms % 1000;
+  host_time(tloc);
+  if (out_ms) *out_ms = ms;
+  return ms;
+}
+
+struct tm *host_localtime(const time_t *timep) {
+  return gmtime_r(timep, &s_tm);
+}
+
+void host_clock_set(time_t now) {
+  s_clock_ms = (uint64_t)now * 1000;
+}
+
+uint64_t host_clock_ms(void) {
+  return s_clock_ms;
+}
+
+// --------------------------------------------------------------- logging
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+  host_stats.logs++;
+  if (!getenv("HOST_APP_LOG")) return;
+
+  va_list va;
+  va_start(va, fmt);
+  fprintf(stderr, "[%d] %s:%d ", log_level, src_filename, src_line_number);
+  vfprintf(stderr, fmt, va);
+  fputc('\n', stderr);
+  va_end(va);
+}
+
+// ------------------------------------------------------------- resources
+
+struct ResourceEntry {
+  const char *name;
+  const char *type;
+  const char *file;
+};
+
+static struct ResourceEntry s_resources[HOST_RESOURCE_COUNT + 1] = HOST_RESOURCE_TABLE;
+
+static FILE *resource_open(ResHandle h) {
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s", HOST_RESOURCES_DIR, h->file);
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "pebble_host: cannot open resource %s\n", path);
+    exit(1);
+  }
+  return f;
+}
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+  if (resource_id == 0 || resource_id > HOST_RESOURCE_COUNT) return NULL;
+  return &s_resources[resource_id];
+}
+
+size_t resource_size(ResHandle h) {
+  FILE *f = resource_open(h);
+  fseek(f, 0, SEEK_END);
+  size_t size = ftell(f);
+  fclose(f);
+  return size;
+}
+
+size_t resource_load(ResHandle h, uint8_t *buffer, size_t max_length) {
+  return resource_load_byte_range(h, 0, buffer, max_length);
+}
+
+size_t resource_load_byte_range(ResHandle h, uint32_t start_offset, uint8_t *buffer, size_t num_bytes) {
+  FILE *f = resource_open(h);
+  size_t len = fseek(f, start_offset, SEEK_SET) == 0 ? fread(buffer, 1, num_bytes, f) : 0;
+  fclose(f);
+  host_stats.resource_reads++;
+  host_stats.resource_bytes += len;
+  return len;
+}
+
+// ------------------------------------------------------------------ fonts
+
+static struct FontInfo s_system_fonts[] = {
+  { FONT_KEY_GOTHIC_14, 14, false },
+  { FONT_KEY_GOTHIC_18, 18, false },
+  { FONT_KEY_GOTHIC_24, 24, false },
+  { FONT_KEY_GOTHIC_28, 28, false },
+  { FONT_KEY_GOTHIC_28_BOLD, 28, false },
+  { FONT_KEY_BITHAM_42_BOLD, 42, false },
+};
+
+GFont fonts_get_system_font(const char *font_key) {
+  for (unsigned i = 0; i < sizeof(s_system_fonts) / sizeof(s_system_fonts[0]); i++) {
+    if (strcmp(s_system_fonts[i].name, font_key) == 0) return &s_system_fonts[i];
+  }
+  return &s_system_fonts[0];
+}
+
+GFont fonts_load_custom_font(ResHandle handle) {
+  // Font resources are named <NAME>_<height>, as the SDK expects
+  const char *size = strrchr(handle->name, '_');
+  struct FontInfo *font = host_alloc(sizeof(struct FontInfo), HOST_ALLOC_FONT);
+  font->name = handle->name;
+  font->size = size ? atoi(size + 1) : 14;
+  font->custom = true;
+  host_stats.resource_reads++;
+  return font;
+}
+
+void fonts_unload_custom_font(GFont font) {
+  host_free(font);
+}
+
+// --------------------------------------------------------------- bitmaps
+
+static uint32_t be32(const uint8_t *p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id) {
+  ResHandle h = resource_get_handle(resource_id);
+  uint8_t header[24];
+  if (!h || resource_load(h, header, sizeof(header)) != sizeof(header)) return NULL;
+
+  // Decoded to 1 bit per pixel, rows padded to 32 bits as on the watch
+  int w = be32(header + 16);
+  int hgt = be32(header + 20);
+  GBitmap *bitmap = host_alloc(sizeof(GBitmap), HOST_ALLOC_BITMAP);
+  bitmap->row_size_bytes = ((w + 31) / 32) * 4;
+  bitmap->addr = host_alloc(bitmap->row_size_bytes * hgt, HOST_ALLOC_BITMAP);
+  bitmap->info_flags = 1;
+  bitmap->bounds = GRect(0, 0, w, hgt);
+
+  // The pixels are only needed to draw, not counted as the watch reads them
+  if (s_renderer) {
+    FILE *f = resource_open(h);
+    size_t size = resource_size(h);
+    uint8_t *data = (malloc)(size);
+    if (fread(data, 1, size, f) == size) s_renderer->decode_png(data, size, bitmap);
+    (free)(data);
+    fclose(f);
+  }
+  return bitmap;
+}
+
+// .pbi data: row size, flags and bounds (16 bits each), then the pixels,
+// which stay owned by the caller
+GBitmap *gbitmap_create_with_data(const uint8_t *data) {
+  GBitmap *bitmap = host_alloc(sizeof(GBitmap), HOST_ALLOC_BITMAP);
+  const uint16_t *header = (const uint16_t *)data;
+  bitmap->row_size_bytes = header[0];
+  bitmap->info_flags = 0;
+  bitmap->bounds = GRect((int16_t)header[2], (int16_t)header[3], (int16_t)header[4], (int16_t)header[5]);
+  bitmap->addr = (void *)(data + 12);
+  return bitmap;
+}
+
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base_bitmap, GRect sub_rect) {
+  GBitmap *bitmap = host_alloc(sizeof(GBitmap), HOST_ALLOC_BITMAP);
+  *bitmap = *base_bitmap;
+  bitmap->info_flags = 0;
+  bitmap->bounds = sub_rect;
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (!bitmap) return;
+  if (bitmap->info_flags & 1) host_free(bitmap->addr);
+  host_free(bitmap);
+}
+
+// --------------------------------------------------------------- graphics
+
+
+static int text_glyphs(const char *text) {
+  int glyphs = 0;
+  for (const char *c = text; *c; c++) {
+    if ((*c & 0xC0) != 0x80) glyphs++;
+  }
+  return glyphs;
+}
+
+// Rough metrics: an average advance of 55% of the font height per glyph for
+// the system fonts, 40% for the narrow Domestic Manners custom font
+static GSize text_extent(const char *text, const GFont font, int max_w, int *glyphs) {
+  int n = text_glyphs(text);
+  int w = n * font->size * (font->custom ? 40 : 55) / 100;
+  if (w > max_w) w = max_w;
+  if (glyphs) *glyphs = n;
+  return GSize(w, font->size);
+}
+
+GSize graphics_text_layout_get_content_size(const char *text, const GFont font, const GRect box,
+                                            const GTextOverflowMode overflow_mode,
+                                            const GTextAlignment alignment) {
+  host_stats.text_measured++;
+  return text_extent(text, font, box.size.w, NULL);
+}
+
+// ----------------------------------------------------------------- layers
+
+static GPoint layer_screen_origin(const Layer *layer) {
+  GPoint origin = layer->frame.origin;
+  for (const Layer *p = layer->parent; p; p = p->parent) {
+    origin.x += p->frame.origin.x;
+    origin.y += p->frame.origin.y;
+  }
+  return origin;
+}
+
+static uint32_t screen_area(GPoint origin, GSize size) {
+  int x0 = origin.x < 0 ? 0 : origin.x;
+  int y0 = origin.y < 0 ? 0 : origin.y;
+  int x1 = origin.x + size.w > HOST_SCREEN_W ? HOST_SCREEN_W : origin.x + size.w;
+  int y1 = origin.y + size.h > HOST_SCREEN_H ? HOST_SCREEN_H : origin.y + size.h;
+  return (x1 > x0 && y1 > y0) ? (uint32_t)(x1 - x0) * (y1 - y0) : 0;
+}
+
+static void layer_init(Layer *layer, GRect frame, HostLayerKind kind) {
+  memset(layer, 0, sizeof(Layer));
+  layer->frame = frame;
+  layer->kind = kind;
+}
+
+static void layer_remove_from_parent(Layer *layer) {
+  if (!layer->parent) return;
+  Layer **link = &layer->parent->first_child;
+  while (*link && *link != layer) link = &(*link)->next_sibling;
+  if (*link) *link = layer->next_sibling;
+  layer->parent = NULL;
+  layer->next_sibling = NULL;
+}
+
+Layer *layer_create(GRect frame) {
+  Layer *layer = host_alloc(sizeof(Layer), HOST_ALLOC_LAYER);
+  layer_init(layer, frame, HOST_LAYER_PLAIN);
+  return layer;
+}
+
+void layer_destroy(Layer *layer) {
+  if (!layer) return;
+  layer_remove_from_parent(layer);
+  host_free(layer);
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_mark_dirty(Layer *layer) {
+  host_stats.layer_dirty++;
+  s_needs_redraw = true;
+  if (!layer->hidden) host_stats.dirty_area += screen_area(layer_screen_origin(layer), layer->frame.size);
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+  host_stats.frame_changes++;
+  if (memcmp(&layer->frame, &frame, sizeof(GRect)) == 0) return;
+
+  // Both the uncovered and the newly covered area need a redraw
+  layer_mark_dirty(layer);
+  layer->frame = frame;
+  layer_mark_dirty(layer);
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+  layer_remove_from_parent(child);
+  Layer **link = &parent->first_child;
+  while (*link) link = &(*link)->next_sibling;
+  *link = child;
+  child->parent = parent;
+  layer_mark_dirty(child);
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  if (layer->hidden == hidden) return;
+  if (hidden) layer_mark_dirty(layer);
+  layer->hidden = hidden;
+  if (!hidden) layer_mark_dirty(layer);
+}
+
+bool layer_get_hidden(const Layer *layer) {
+  return layer->hidden;
+}
+
+TextLayer *text_layer_create(GRect frame) {
+  TextLayer *text_layer = host_alloc(sizeof(TextLayer), HOST_ALLOC_TEXT_LAYER);
+  layer_init(&text_layer->layer, frame, HOST_LAYER_TEXT);
+  text_layer->font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+  text_layer->background_color = GColorWhite;
+  text_layer->text_color = GColorBlack;
+  return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+  if (!text_layer) return;
+  layer_remove_from_parent(&text_layer->layer);
+  host_free(text_layer);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+  return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+  host_stats.text_set++;
+  text_layer->text = text;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+const char *text_layer_get_text(TextLayer *text_layer) {
+  return text_layer->text;
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+  text_layer->background_color = color;
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {
+  text_layer->text_color = color;
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {
+  text_layer->font = font;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment) {
+  text_layer->alignment = text_alignment;
+}
+
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode) {
+  text_layer->overflow_mode = line_mode;
+}
+
+GSize text_layer_get_content_size(TextLayer *text_layer) {
+  return graphics_text_layout_get_content_size(text_layer->text ? text_layer->text : "",
+                                               text_layer->font, text_layer->layer.frame,
+                                               text_layer->overflow_mode, text_layer->alignment);
+}
+
+BitmapLayer *bitmap_layer_create(GRect frame) {
+  BitmapLayer *bitmap_layer = host_alloc(sizeof(BitmapLayer), HOST_ALLOC_BITMAP_LAYER);
+  layer_init(&bitmap_layer->layer, frame, HOST_LAYER_BITMAP);
+  bitmap_layer->background_color = GColorClear;
+  return bitmap_layer;
+}
+
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer) {
+  if (!bitmap_layer) return;
+  layer_remove_from_parent(&bitmap_layer->layer);
+  host_free(bitmap_layer);
+}
+
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer) {
+  return (Layer *)&bitmap_layer->layer;
+}
+
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap) {
+  bitmap_layer->bitmap = bitmap;
+  layer_mark_dirty(&bitmap_layer->layer);
+}
+
+void bitmap_layer_set_alignment(BitmapLayer *bitmap_layer, GAlign alignment) {
+  bitmap_layer->alignment = alignment;
+}
+
+void bitmap_layer_set_background_color(BitmapLayer *bitmap_layer, GColor color) {
+  bitmap_layer->background_color = color;
+}
+
+void bitmap_layer_set_compositing_mode(BitmapLayer *bitmap_layer, GCompOp mode) {
+  bitmap_layer->compositing_mode = mode;
+}
+
+// ----------------------------------------------------------------- window
+
+Window *window_create(void) {
+  Window *window = host_alloc(sizeof(Window), HOST_ALLOC_WINDOW);
+  layer_init(&window->root_layer, GRect(0, 0, HOST_SCREEN_W, HOST_SCREEN_H), HOST_LAYER_WINDOW);
+  window->background_color = GColorWhite;
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (window->loaded && window->handlers.unload) window->handlers.unload(window);
+  window->loaded = false;
+  if (s_top_window == window) s_top_window = NULL;
+  host_free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+void window_set_background_color(Window *window, GColor background_color) {
+  window->background_color = background_color;
+}
+
+void window_stack_push(Window *window, bool animated) {
+  s_top_window = window;
+  if (!window->loaded && window->handlers.load) {
+    EventMark start = event_begin();
+    window->handlers.load(window);
+    event_done(HOST_EVENT_LOAD, start);
+  }
+  window->loaded = true;
+  if (window->handlers.appear) window->handlers.appear(window);
+  layer_mark_dirty(&window->root_layer);
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return (Layer *)&window->root_layer;
+}
+
+Window *host_top_window(void) {
+  return s_top_window;
+}
+
+// ----------------------------------------------------------------- redraw
+
+static GRect rect_clip(GRect rect, GRect clip) {
+  int x0 = rect.origin.x > clip.origin.x ? rect.origin.x : clip.origin.x;
+  int y0 = rect.origin.y > clip.origin.y ? rect.origin.y : clip.origin.y;
+  int x1 = rect.origin.x + rect.size.w < clip.origin.x + clip.size.w ? rect.origin.x + rect.size.w : clip.origin.x + clip.size.w;
+  int y1 = rect.origin.y + rect.size.h < clip.origin.y + clip.size.h ? rect.origin.y + rect.size.h : clip.origin.y + clip.size.h;
+  return (x1 > x0 && y1 > y0) ? GRect(x0, y0, x1 - x0, y1 - y0) : GRectZero;
+}
+
+// What an update_proc draws with: its layer on screen, and the state the
+// graphics_context_set_ calls leave
+struct GContext {
+  GPoint origin;
+  GRect clip;
+  GColor text_color;
+  GCompOp compositing_mode;
+  HostEventStats *event;
+};
+
+static void count_drawn(HostEventStats *event, uint32_t glyphs, uint32_t pixels) {
+  host_stats.glyphs_drawn += glyphs;
+  host_stats.pixels_drawn += pixels;
+  event->glyphs_drawn += glyphs;
+  event->pixels_drawn += pixels;
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+  ctx->text_color = color;
+}
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) {
+  ctx->compositing_mode = mode;
+}
+
+// Counted as a TextLayer of that box would be
+void graphics_draw_text(GContext *ctx, const char *text, const GFont font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        const void *layout) {
+  GRect screen = { { ctx->origin.x + box.origin.x, ctx->origin.y + box.origin.y }, box.size };
+  if (!screen_area(screen.origin, screen.size)) return;
+  int glyphs;
+  GSize size = text_extent(text, font, box.size.w, &glyphs);
+  count_drawn(ctx->event, glyphs, screen_area(screen.origin, size));
+
+  GRect clip = rect_clip(screen, ctx->clip);
+  if (s_renderer && clip.size.w) s_renderer->draw_text(text, font, screen, alignment, ctx->text_color, clip);
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+  GRect screen = { { ctx->origin.x + rect.origin.x, ctx->origin.y + rect.origin.y }, rect.size };
+  count_drawn(ctx->event, 0, screen_area(screen.origin, screen.size));
+
+  GRect clip = rect_clip(screen, ctx->clip);
+  if (s_renderer && clip.size.w) s_renderer->draw_bitmap(bitmap, screen, ctx->compositing_mode, clip);
+}
+
+// What a layer shows, for the renderer, in screen coordinates
+static void layer_render(const Layer *layer, GRect box, GRect clip) {
+  if (layer->kind == HOST_LAYER_TEXT) {
+    const TextLayer *text_layer = (const TextLayer *)layer;
+    if (text_layer->background_color != GColorClear) s_renderer->fill_rect(clip, text_layer->background_color);
+    if (text_layer->text) {
+      s_renderer->draw_text(text_layer->text, text_layer->font, box, text_layer->alignment,
+                            text_layer->text_color, clip);
+    }
+  } else if (layer->kind == HOST_LAYER_BITMAP) {
+    const BitmapLayer *bitmap_layer = (const BitmapLayer *)layer;
+    if (bitmap_layer->background_color != GColorClear) s_renderer->fill_rect(clip, bitmap_layer->background_color);
+    if (bitmap_layer->bitmap) {
+      GSize size = bitmap_layer->bitmap->bounds.size;
+      GAlign align = bitmap_layer->alignment;
+      int dx = box.size.w - size.w, dy = box.size.h - size.h;
+      // left, centered or right, then top, centered or bottom
+      int ax = (align == GAlignTopLeft || align == GAlignLeft || align == GAlignBottomLeft) ? 0 :
+               (align == GAlignTopRight || align == GAlignRight || align == GAlignBottomRight) ? dx : dx / 2;
+      int ay = (align == GAlignTopLeft || align == GAlignTop || align == GAlignTopRight) ? 0 :
+               (align == GAlignBottomLeft || align == GAlignBottom || align == GAlignBottomRight) ? dy : dy / 2;
+      GRect rect = GRect(box.origin.x + ax, box.origin.y + ay, size.w, size.h);
+      s_renderer->draw_bitmap(bitmap_layer->bitmap, rect, bitmap_layer->compositing_mode, clip);
+    }
+  }
+}
+
+// SDK 2 redraws the whole window whenever a layer is dirty, every visible
+// layer draws what it shows on screen, clipped to its parents.
+static void layer_draw(const Layer *layer, GPoint origin, GRect clip, HostEventStats *event) {
+  if (layer->hidden) return;
+  origin.x += layer->frame.origin.x;
+  origin.y += layer->frame.origin.y;
+  GRect box = { origin, layer->frame.size };
+  clip = rect_clip(box, clip);
+  if (s_renderer && clip.size.w) layer_render(layer, box, clip);
+
+  uint32_t glyphs = 0;
+  uint32_t pixels = 0;
+  if (layer->kind == HOST_LAYER_TEXT) {
+    const TextLayer *text_layer = (const TextLayer *)layer;
+    if (text_layer->text && screen_area(origin, layer->frame.size)) {
+      int n;
+      GSize size = text_extent(text_layer->text, text_layer->font, layer->frame.size.w, &n);
+      glyphs = n;
+      pixels = screen_area(origin, size);
+    }
+  } else if (layer->kind == HOST_LAYER_BITMAP) {
+    const BitmapLayer *bitmap_layer = (const BitmapLayer *)layer;
+    if (bitmap_layer->bitmap) {
+      GSize size = bitmap_layer->bitmap->bounds.size;
+      if (size.w > layer->frame.size.w) size.w = layer->frame.size.w;
+      if (size.h > layer->frame.size.h) size.h = layer->frame.size.h;
+      pixels = screen_area(origin, size);
+    }
+  }
+  count_drawn(event, glyphs, pixels);
+
+  if (layer->update_proc && clip.size.w) {
+    GContext ctx = { origin, clip, GColorBlack, GCompOpAssign, event };
+    layer->update_proc((Layer *)layer, &ctx);
+  }
+
+  for (const Layer *child = layer->first_child; child; child = child->next_sibling) {
+    layer_draw(child, origin, clip, event);
+  }
+}
+
+static void window_redraw(HostEventStats *event) {
+  s_needs_redraw = false;
+  if (!s_top_window) return;
+  host_stats.redraws++;
+  if (s_renderer) s_renderer->begin(s_top_window->background_color);
+  uint64_t start = host_cycles();
+  layer_draw(&s_top_window->root_layer, GPoint(0, 0), GRect(0, 0, HOST_SCREEN_W, HOST_SCREEN_H), event);
+  host_stats.redraw_cycles += host_cycles() - start;
+  if (s_renderer) s_renderer->end();
+  if (!host_stats.first_frame_at) host_stats.first_frame_at = host_cycles();
+}
+
+// -------------------------------------------------------------- animation
+
+typedef struct {
+  Animation *animation;
+  bool scheduled;
+  bool started;
+} AnimationSlot;
+
+static AnimationSlot s_animations[MAX_ANIMATIONS];
+static bool s_in_transition;
+
+static AnimationSlot *animation_slot(Animation *animation) {
+  // Pointers are only compared, so stale handles are safe to look up
+  for (int i = 0; i < MAX_ANIMATIONS; i++) {
+    if (animation && s_animations[i].animation == animation) return &s_animations[i];
+  }
+  return NULL;
+}
+
+static void animation_register(Animation *animation) {
+  AnimationSlot *slot = NULL;
+  for (int i = 0; i < MAX_ANIMATIONS && !slot; i++) {
+    if (!s_animations[i].animation) slot = &s_animations[i];
+  }
+  if (!slot) {
+    fprintf(stderr, "pebble_host: too many live animations\n");
+    exit(1);
+  }
+  slot->animation = animation;
+  slot->scheduled = false;
+  host_stats.animations_created++;
+}
+
+static void animation_init(Animation *animation) {
+  memset(animation, 0, sizeof(Animation));
+  animation->duration_ms = 250;
+  animation->curve = AnimationCurveEaseInOut;
+}
+
+Animation *animation_create(void) {
+  Animation *animation = host_alloc(sizeof(Animation), HOST_ALLOC_ANIMATION);
+  animation_init(animation);
+  animation_register(animation);
+  return animation;
+}
+
+void animation_destroy(Animation *animation) {
+  AnimationSlot *slot = animation_slot(animation);
+  if (!slot) return;
+  animation_unschedule(animation);
+  slot->animation = NULL;
+  host_stats.animations_destroyed++;
+  host_free(animation);
+}
+
+void animation_set_delay(Animation *animation, uint32_t delay_ms) {
+  animation->delay_ms = delay_ms;
+}
+
+void animation_set_duration(Animation *animation, uint32_t duration_ms) {
+  animation->duration_ms = duration_ms;
+}
+
+void animation_set_curve(Animation *animation, AnimationCurve curve) {
+  animation->curve = curve;
+}
+
+void animation_set_handlers(Animation *animation, AnimationHandlers callbacks, void *context) {
+  animation->handlers = callbacks;
+  animation->context = context;
+}
+
+void animation_set_implementation(Animation *animation, const AnimationImplementation *implementation) {
+  animation->implementation = implementation;
+}
+
+void *animation_get_context(Animation *animation) {
+  return animation->context;
+}
+
+void animation_schedule(Animation *animation) {
+  AnimationSlot *slot = animation_slot(animation);
+  if (!slot) return;
+  if (slot->scheduled) animation_unschedule(animation);
+  slot->scheduled = true;
+  slot->started = false;
+  animation->abs_start_time_ms = (uint32_t)s_clock_ms + animation->delay_ms;
+  animation->is_completed = false;
+  host_stats.animations_scheduled++;
+}
+
+static void animation_stop(AnimationSlot *slot, bool finished) {
+  Animation *animation = slot->animation;
+  slot->scheduled = false;
+  animation->is_completed = finished;
+  if (slot->started && animation->implementation && animation->implementation->teardown) {
+    host_stats.animation_handlers++;
+    animation->implementation->teardown(animation);
+  }
+  if (animation->handlers.stopped) {
+    host_stats.animation_handlers++;
+    animation->handlers.stopped(animation, finished, animation->context);
+  }
+}
+
+void animation_unschedule(Animation *animation) {
+  AnimationSlot *slot = animation_slot(animation);
+  if (slot && slot->scheduled) animation_stop(slot, false);
+}
+
+void animation_unschedule_all(void) {
+  for (int i = 0; i < MAX_ANIMATIONS; i++) {
+    if (s_animations[i].animation && s_animations[i].scheduled) animation_stop(&s_animations[i], false);
+  }
+}
+
+bool animation_is_scheduled(Animation *animation) {
+  AnimationSlot *slot = animation_slot(animation);
+  return slot && slot->scheduled;
+}
+
+static uint32_t animation_curve(AnimationCurve curve, uint32_t t) {
+  uint32_t max = ANIMATION_NORMALIZED_MAX;
+  switch (curve) {
+    case AnimationCurveEaseIn:
+      return t * t / max;
+    case AnimationCurveEaseOut:
+      return max - (max - t) * (max - t) / max;
+    case AnimationCurveEaseInOut:
+      if (t < max / 2) return 2 * t * t / max;
+      return max - 2 * (max - t) * (max - t) / max;
+    default:
+      return t;
+  }
+}
+
+static bool animations_pending(void) {
+  for (int i = 0; i < MAX_ANIMATIONS; i++) {
+    if (s_animations[i].animation && s_animations[i].scheduled) return true;
+  }
+  return false;
+}
+
+static void animations_frame(void) {
+  Animation *due[MAX_ANIMATIONS];
+  int count = 0;
+
+  // Handlers may (un)schedule or destroy animations, work on a snapshot
+  for (int i = 0; i < MAX_ANIMATIONS; i++) {
+    if (s_animations[i].animation && s_animations[i].scheduled) due[count++] = s_animations[i].animation;
+  }
+
+  for (int i = 0; i < count; i++) {
+    AnimationSlot *slot = animation_slot(due[i]);
+    if (!slot || !slot->scheduled) continue;
+    Animation *animation = slot->animation;
+    if (s_clock_ms < animation->abs_start_time_ms) continue;
+
+    if (!slot->started) {
+      slot->started = true;
+      if (animation->handlers.started) {
+        host_stats.animation_handlers++;
+        animation->handlers.started(animation, animation->context);
+      }
+      if (animation->implementation && animation->implementation->setup) {
+        host_stats.animation_handlers++;
+        animation->implementation->setup(animation);
+      }
+      if (!slot->scheduled) continue;
+    }
+
+    uint32_t elapsed = (uint32_t)s_clock_ms - animation->abs_start_time_ms;
+    uint32_t t = ANIMATION_NORMALIZED_MAX;
+    if (elapsed < animation->duration_ms) t = (uint64_t)elapsed * ANIMATION_NORMALIZED_MAX / animation->duration_ms;
+
+    if (animation->implementation && animation->implementation->update) {
+      host_stats.animation_frames++;
+      animation->implementation->update(animation, animation_curve(animation->curve, t));
+    }
+    if (t == ANIMATION_NORMALIZED_MAX && slot->scheduled) animation_stop(slot, true);
+  }
+}
+
+static int16_t interpolate(int16_t from, int16_t to, uint32_t distance) {
+  return from + (int32_t)(to - from) * (int32_t)distance / ANIMATION_NORMALIZED_MAX;
+}
+
+static void property_animation_update_layer_frame(Animation *animation, const uint32_t distance) {
+  PropertyAnimation *property_animation = (PropertyAnimation *)animation;
+  GRect from = property_animation->values.from.grect;
+  GRect to = property_animation->values.to.grect;
+  layer_set_frame(property_animation->subject,
+                  GRect(interpolate(from.origin.x, to.origin.x, distance),
+                        interpolate(from.origin.y, to.origin.y, distance),
+                        interpolate(from.size.w, to.size.w, distance),
+                        interpolate(from.size.h, to.size.h, distance)));
+}
+
+static const AnimationImplementation s_layer_frame_implementation = {
+  .update = property_animation_update_layer_frame,
+};
+
+PropertyAnimation *property_animation_create_layer_frame(struct Layer *layer, GRect *from_frame, GRect *to_frame) {
+  PropertyAnimation *property_animation = host_alloc(sizeof(PropertyAnimation), HOST_ALLOC_ANIMATION);
+  animation_init(&property_animation->animation);
+  animation_register(&property_animation->animation);
+  property_animation->animation.implementation = &s_layer_frame_implementation;
+  property_animation->subject = layer;
+  property_animation->values.from.grect = from_frame ? *from_frame : layer->frame;
+  property_animation->values.to.grect = to_frame ? *to_frame : layer->frame;
+  return property_animation;
+}
+
+void property_animation_destroy(PropertyAnimation *property_animation) {
+  animation_destroy((Animation *)property_animation);
+}
+
+// ----------------------------------------------------------------- timers
+
+typedef struct {
+  bool active;
+  uint64_t due_ms;
+  AppTimerCallback callback;
+  void *data;
+} HostTimer;
+
+static HostTimer s_timers[MAX_TIMERS];
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    if (!s_timers[i].active) {
+      s_timers[i] = (HostTimer) { true, s_clock_ms + timeout_ms, callback, callback_data };
+      host_stats.timers_registered++;
+      return (AppTimer *)&s_timers[i];
+    }
+  }
+  return NULL;
+}
+
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms) {
+  HostTimer *timer = (HostTimer *)timer_handle;
+  if (!timer || !timer->active) return false;
+  timer->due_ms = s_clock_ms + new_timeout_ms;
+  return true;
+}
+
+void app_timer_cancel(AppTimer *timer_handle) {
+  HostTimer *timer = (HostTimer *)timer_handle;
+  if (timer) timer->active = false;
+}
+
+static HostTimer *timer_next(void) {
+  HostTimer *next = NULL;
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    if (s_timers[i].active && (!next || s_timers[i].due_ms < next->due_ms)) next = &s_timers[i];
+  }
+  return next;
+}
+
+// --------------------------------------------------------------- services
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+  s_tick_units = tick_units;
+  s_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+  s_tick_handler = NULL;
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+  s_battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void) {
+  s_battery_handler = NULL;
+}
+
+BatteryChargeState battery_state_service_peek(void) {
+  return s_battery_state;
+}
+
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler) {
+  s_bt_handler = handler;
+}
+
+void bluetooth_connection_service_unsubscribe(void) {
+  s_bt_handler = NULL;
+}
+
+bool bluetooth_connection_service_peek(void) {
+  return s_bt_connected;
+}
+
+void host_battery_event(BatteryChargeState state) {
+  s_battery_state = state;
+  if (!s_battery_handler) return;
+  EventMark start = event_begin();
+  s_battery_handler(state);
+  event_done(HOST_EVENT_BATTERY, start);
+}
+
+void host_bt_event(bool connected) {
+  s_bt_connected = connected;
+  if (!s_bt_handler) return;
+  EventMark start = event_begin();
+  s_bt_handler(connected);
+  event_done(HOST_EVENT_BLUETOOTH, start);
+}
+
+void vibes_short_pulse(void) {
+  host_stats.vibes++;
+}
+
+void vibes_double_pulse(void) {
+  host_stats.vibes++;
+}
+
+void vibes_long_pulse(void) {
+  host_stats.vibes++;
+}
+
+// ---------------------------------------------------------------- persist
+
+typedef struct {
+  bool used;
+  uint32_t key;
+  size_t size;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistEntry;
+
+static PersistEntry s_persist[MAX_PERSIST_KEYS];
+
+static PersistEntry *persist_find(uint32_t key) {
+  for (int i = 0; i < MAX_PERSIST_KEYS; i++) {
+    if (s_persist[i].used && s_persist[i].key == key) return &s_persist[i];
+  }
+  return NULL;
+}
+
+bool persist_exists(const uint32_t key) {
+  return persist_find(key) != NULL;
+}
+
+int persist_get_size(const uint32_t key) {
+  PersistEntry *entry = persist_find(key);
+  return entry ? (int)entry->size : E_DOES_NOT_EXIST;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+  PersistEntry *entry = persist_find(key);
+  if (!entry) return E_DOES_NOT_EXIST;
+  size_t size = entry->size < buffer_size ? entry->size : buffer_size;
+  memcpy(buffer, entry->data, size);
+  return size;
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+  PersistEntry *entry = persist_find(key);
+  for (int i = 0; i < MAX_PERSIST_KEYS && !entry; i++) {
+    if (!s_persist[i].used) entry = &s_persist[i];
+  }
+  if (!entry) return E_OUT_OF_STORAGE;
+  entry->used = true;
+  entry->key = key;
+  entry->size = size < PERSIST_DATA_MAX_LENGTH ? size : PERSIST_DATA_MAX_LENGTH;
+  memcpy(entry->data, data, entry->size);
+  return entry->size;
+}
+
+bool persist_read_bool(const uint32_t key) {
+  bool value = false;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+int32_t persist_read_int(const uint32_t key) {
+  int32_t value = 0;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+int persist_read_string(const uint32_t key, char *buffer, const size_t buffer_size) {
+  int size = persist_read_data(key, buffer, buffer_size);
+  if (size > 0) buffer[buffer_size - 1] = '\0';
+  return size;
+}
+
+status_t persist_write_bool(const uint32_t key, const bool value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+status_t persist_write_int(const uint32_t key, const int32_t value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_write_string(const uint32_t key, const char *cstring) {
+  return persist_write_data(key, cstring, strlen(cstring) + 1);
+}
+
+status_t persist_delete(const uint32_t key) {
+  PersistEntry *entry = persist_find(key);
+  if (!entry) return E_DOES_NOT_EXIST;
+  entry->used = false;
+  return S_SUCCESS;
+}
+
+// ------------------------------------------------------------- event loop
+
+static uint32_t tick_period_ms(void) {
+  return (s_tick_units & SECOND_UNIT) ? 1000 : 60000;
+}
+
+static void tick(void) {
+  time_t now = host_time(NULL);
+  struct tm tick_time;
+  gmtime_r(&now, &tick_time);
+
+  TimeUnits units = SECOND_UNIT;
+  if (tick_time.tm_sec == 0) units |= MINUTE_UNIT;
+  if (units & MINUTE_UNIT && tick_time.tm_min == 0) units |= HOUR_UNIT;
+  if (units & HOUR_UNIT && tick_time.tm_hour == 0) units |= DAY_UNIT;
+  if (units & DAY_UNIT && tick_time.tm_mday == 1) units |= MONTH_UNIT;
+  if (units & MONTH_UNIT && tick_time.tm_mon == 0) units |= YEAR_UNIT;
+  if (!(units & s_tick_units)) return;
+
+  EventMark start = event_begin();
+  s_tick_handler(&tick_time, units);
+  event_done(HOST_EVENT_TICK, start);
+}
+
+void host_run_for(uint32_t ms) {
+  uint64_t end = s_clock_ms + ms;
+  uint64_t next_frame = s_clock_ms + HOST_ANIMATION_FRAME_MS;
+
+  while (s_clock_ms < end) {
+    uint64_t next = end;
+    uint64_t next_tick = (s_clock_ms / tick_period_ms() + 1) * tick_period_ms();
+    HostTimer *timer = timer_next();
+    bool animating = animations_pending();
+
+    if (s_tick_handler && next_tick < next) next = next_tick;
+    if (timer && timer->due_ms < next) next = timer->due_ms < s_clock_ms ? s_clock_ms : timer->due_ms;
+    if (animating && next_frame < next) next = next_frame;
+    if (!animating) next_frame = next + HOST_ANIMATION_FRAME_MS;
+    if (animating && !s_in_transition) host_stats.transitions++;
+    s_in_transition = animating;
+
+    s_clock_ms = next;
+
+    if (timer && timer->due_ms <= s_clock_ms) {
+      EventMark start = event_begin();
+      timer->active = false;
+      timer->callback(timer->data);
+      event_done(HOST_EVENT_TIMER, start);
+    }
+    if (animating && next_frame <= s_clock_ms) {
+      EventMark start = event_begin();
+      next_frame = s_clock_ms + HOST_ANIMATION_FRAME_MS;
+      animations_frame();
+      event_done(HOST_EVENT_ANIMATION, start);
+    }
+    if (s_tick_handler && s_clock_ms == next_tick) tick();
+  }
+}
+
+void host_app_exit(void) {
+  // What the firmware drops when an app exits (the persist storage stays)
+  s_tick_handler = NULL;
+  s_battery_handler = NULL;
+  s_bt_handler = NULL;
+  memset(s_timers, 0, sizeof(s_timers));
+  for (int i = 0; i < MAX_ANIMATIONS; i++) {
+    if (s_animations[i].animation) fprintf(stderr, "pebble_host: animation leaked at exit\n");
+  }
+  memset(s_animations, 0, sizeof(s_animations));
+  s_in_transition = false;
+}
+
+void host_set_renderer(const HostRenderer *renderer) {
+  s_renderer = renderer;
+}
+
+void host_set_event_loop(void (*loop)(void)) {
+  s_event_loop = loop;
+}
+
+void app_event_loop(void) {
+  if (s_event_loop) s_event_loop();
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+/*
+ * Harness side of the host Pebble stub: the layer/window internals the stub
+ * keeps, the call/allocation counters, and the simulated clock that feeds
+ * ticks, timers, animation frames and service events into the app.
+ */
+
+#include "pebble.h"
+
+#define HOST_SCREEN_W 144
+#define HOST_SCREEN_H 168
+
+// Animation frame period used by the simulated scheduler (about 30 fps)
+#define HOST_ANIMATION_FRAME_MS 33
+
+typedef enum {
+  HOST_LAYER_PLAIN,
+  HOST_LAYER_TEXT,
+  HOST_LAYER_BITMAP,
+  HOST_LAYER_WINDOW,
+} HostLayerKind;
+
+struct Layer {
+  GRect frame;
+  bool hidden;
+  HostLayerKind kind;
+  LayerUpdateProc update_proc;
+  struct Layer *parent;
+  struct Layer *first_child;
+  struct Layer *next_sibling;
+};
+
+struct TextLayer {
+  Layer layer;
+  const char *text;
+  GFont font;
+  GColor background_color;
+  GColor text_color;
+  GTextAlignment alignment;
+  GTextOverflowMode overflow_mode;
+};
+
+struct BitmapLayer {
+  Layer layer;
+  const GBitmap *bitmap;
+  GAlign alignment;
+  GColor background_color;
+  GCompOp compositing_mode;
+};
+
+struct Window {
+  Layer root_layer;
+  WindowHandlers handlers;
+  GColor background_color;
+  bool loaded;
+};
+
+struct FontInfo {
+  const char *name;
+  int size;
+  bool custom;
+};
+
+typedef enum {
+  HOST_EVENT_LOAD,        // window load handler
+  HOST_EVENT_TICK,        // tick timer service
+  HOST_EVENT_TIMER,       // app timers
+  HOST_EVENT_ANIMATION,   // one animation frame, all animations included
+  HOST_EVENT_BATTERY,     // battery state service
+  HOST_EVENT_BLUETOOTH,   // bluetooth connection service
+  HOST_EVENT_COUNT,
+} HostEventKind;
+
+typedef struct {
+  uint32_t count;
+  uint64_t cycles;
+  uint64_t max_cycles;
+  uint64_t dirty_area;   // pixels marked dirty while handling the event
+  uint64_t glyphs_drawn; // by the redraw that follows the event
+  uint64_t pixels_drawn; // text and bitmap pixels of that redraw
+} HostEventStats;
+
+extern const char *const host_event_names[HOST_EVENT_COUNT];
+
+// What the app heap is used for
+typedef enum {
+  HOST_ALLOC_WINDOW,
+  HOST_ALLOC_LAYER,
+  HOST_ALLOC_TEXT_LAYER,
+  HOST_ALLOC_BITMAP_LAYER,
+  HOST_ALLOC_BITMAP,        // GBitmap headers and decoded pixels
+  HOST_ALLOC_FONT,
+  HOST_ALLOC_ANIMATION,
+  HOST_ALLOC_APP,           // the app's own malloc()
+  HOST_ALLOC_OTHER,
+  HOST_ALLOC_COUNT,
+} HostAllocKind;
+
+extern const char *const host_alloc_names[HOST_ALLOC_COUNT];
+
+typedef struct HostStats {
+  HostEventStats events[HOST_EVENT_COUNT];  // app wake-ups, and the cycles spent in them
+  uint32_t text_set;             // text_layer_set_text calls
+  uint32_t text_measured;        // graphics_text_layout_get_content_size calls
+  uint32_t layer_dirty;          // layers marked dirty
+  uint32_t redraws;              // window redraws, at most one per event
+  uint64_t redraw_cycles;        // spent walking the layers of the redraws
+  uint64_t first_frame_at;       // host_cycles() at the end of the first redraw
+  uint64_t glyphs_drawn;         // glyphs rendered by the redraws
+  uint64_t pixels_drawn;         // on-screen text and bitmap pixels drawn
+  uint64_t dirty_area;           // on-screen pixels marked dirty
+  uint32_t frame_changes;        // layer_set_frame calls
+  uint32_t animations_created;
+  uint32_t animations_destroyed;
+  uint32_t animations_scheduled;
+  uint32_t animation_frames;     // animation update callbacks
+  uint32_t animation_handlers;   // started, stopped, setup and teardown callbacks
+  uint32_t transitions;          // runs of consecutive animation frames
+  uint32_t timers_registered;
+  uint32_t vibes;
+  uint32_t resource_reads;
+  uint32_t resource_bytes;
+  uint32_t logs;
+  uint32_t allocs;
+  uint32_t frees;
+  uint32_t bytes_allocated;
+  uint32_t heap_used;
+  uint32_t heap_peak;
+  uint32_t heap_by_kind[HOST_ALLOC_COUNT];
+} HostStats;
+
+extern HostStats host_stats;
+
+// CPU cycle counter (TSC on x86, nanoseconds elsewhere)
+uint64_t host_cycles(void);
+
+// Clears the counters, heap_used is kept and heap_peak restarts from it
+void host_stats_reset(void);
+
+// The app's main(), renamed by the host build
+int pebble_main(void);
+
+// Called by app_event_loop(), this is where a harness drives the app
+void host_set_event_loop(void (*loop)(void));
+
+// Drops subscriptions, timers and animations, so pebble_main() can run again
+void host_app_exit(void);
+
+// Simulated clock, in UTC seconds (the host treats UTC as local time)
+void host_clock_set(time_t now);
+uint64_t host_clock_ms(void);
+
+// Advances the clock, delivering ticks, timers and animation frames
+void host_run_for(uint32_t ms);
+
+// Service events, delivered to the subscribed handlers
+void host_battery_event(BatteryChargeState state);
+void host_bt_event(bool connected);
+
+// Host side allocator, every stub allocation goes through it
+void *host_alloc(size_t size, HostAllocKind kind);
+void host_free(void *ptr);
+
+Window *host_top_window(void);
+
+// Optional drawing backend: the redraws walk the layer tree through it, in
+// screen coordinates, every call clipped to clip. Set before the app
+// creates its bitmaps, so that decode_png gets their pixels.
+typedef struct {
+  void (*begin)(GColor background);
+  void (*fill_rect)(GRect rect, GColor color);
+  void (*draw_text)(const char *text, GFont font, GRect box, GTextAlignment alignment, GColor color, GRect clip);
+  void (*draw_bitmap)(const GBitmap *bitmap, GRect rect, GCompOp op, GRect clip);
+  void (*end)(void);
+  // Fills the 1 bit pixels of a bitmap created from a PNG resource
+  void (*decode_png)(const uint8_t *data, size_t size, GBitmap *bitmap);
+} HostRenderer;
+
+void host_set_renderer(const HostRenderer *renderer);
@@ -0,0 +1,200 @@
+/*
+ * Renders the fuzzy time phrases into the PHRASE_BITMAPS resource, for the
+ * PHRASE_BITMAPS mode of the watchface (see src/phrase_bitmaps.h).
+ *
+ * The input lists '<phrase id> <font size> <UTF-8 phrase>' per line, as
+ * printed by tools/gen_fuzzy_table.py --phrases, the ids of every locale
+ * following each other. The output is, little endian:
+ *
+ *   uint16_t count, reserved          count = 2 * (last id + 1)
+ *   { uint32_t offset, size } [count] entry id * 2 + (size == 48)
+ *   1-bit bitmaps in the SDK's .pbi layout, each 4 byte aligned
+ *
+ * Absent entries have a zero size. As on the watch, a phrase that does not
+ * fit the screen in the big font is drawn in the small one. Text is black
+ * on white, one line from the left edge. As in the SDK's fonts, the baseline is placed so that the
+ * tallest glyph of the font size touches the top, and every bitmap of a
+ * size has the same height.
+ *
+ * usage: render_phrases FONT.ttf PHRASES_FILE OUT.bin
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#define MAX_PHRASES 256
+#define MAX_WIDTH 144
+#define BIG_FONT_SIZE 48
+#define SMALL_FONT_SIZE 36
+#define PBI_HEADER_SIZE 12
+#define PBI_VERSION_1 (1 << 12)
+
+typedef struct {
+  uint8_t *data;
+  uint32_t size;
+} Blob;
+
+typedef struct {
+  int index;
+  int height;
+  int length;
+  FT_ULong text[64];  // codepoints
+} Phrase;
+
+static Phrase s_phrases[MAX_PHRASES * 2];
+static Blob s_blobs[MAX_PHRASES * 2];
+
+static void put16(uint8_t *p, uint32_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+  put16(p, v & 0xFFFF);
+  put16(p + 2, v >> 16);
+}
+
+static int utf8_next(const unsigned char *s, FT_ULong *codepoint) {
+  if (s[0] < 0x80) { *codepoint = s[0]; return 1; }
+  if ((s[0] & 0xE0) == 0xC0) { *codepoint = (s[0] & 0x1F) << 6 | (s[1] & 0x3F); return 2; }
+  if ((s[0] & 0xF0) == 0xE0) { *codepoint = (s[0] & 0x0F) << 12 | (s[1] & 0x3F) << 6 | (s[2] & 0x3F); return 3; }
+  *codepoint = (s[0] & 0x07) << 18 | (s[1] & 0x3F) << 12 | (s[2] & 0x3F) << 6 | (s[3] & 0x3F);
+  return 4;
+}
+
+// Ink extent above and below the baseline of every phrase drawn at height
+static void measure(FT_Face face, int height, int phrases, int *ascender, int *descender) {
+  FT_Set_Pixel_Sizes(face, 0, height);
+  *ascender = *descender = 0;
+  for (int i = 0; i < phrases; i++) {
+    if (s_phrases[i].height != height) continue;
+    for (int c = 0; c < s_phrases[i].length; c++) {
+      if (FT_Load_Char(face, s_phrases[i].text[c], FT_LOAD_RENDER | FT_LOAD_TARGET_MONO)) continue;
+      FT_GlyphSlot g = face->glyph;
+      if (g->bitmap_top > *ascender) *ascender = g->bitmap_top;
+      if ((int)g->bitmap.rows - g->bitmap_top > *descender) *descender = g->bitmap.rows - g->bitmap_top;
+    }
+  }
+}
+
+static int text_width(FT_Face face, int height, const Phrase *p) {
+  FT_Set_Pixel_Sizes(face, 0, height);
+  int w = 0;
+  for (int c = 0; c < p->length; c++) {
+    if (FT_Load_Char(face, p->text[c], FT_LOAD_DEFAULT) == 0) w += face->glyph->advance.x >> 6;
+  }
+  return w;
+}
+
+static Blob render(FT_Face face, int height, int ascender, int descender, const Phrase *p) {
+  int w = text_width(face, height, p);
+  int h = ascender + descender;
+  if (w > MAX_WIDTH) w = MAX_WIDTH;
+  if (w == 0) w = 1;
+
+  int row_size = (w + 31) / 32 * 4;
+  Blob blob = { calloc(1, PBI_HEADER_SIZE + row_size * h), PBI_HEADER_SIZE + row_size * h };
+  uint8_t *pixels = blob.data + PBI_HEADER_SIZE;
+  put16(blob.data, row_size);
+  put16(blob.data + 2, PBI_VERSION_1);
+  put16(blob.data + 8, w);
+  put16(blob.data + 10, h);
+  memset(pixels, 0xFF, row_size * h);
+
+  // 1 is white, pixel x of a row is bit x % 8 of byte x / 8
+  int pen = 0;
+  for (int c = 0; c < p->length; c++) {
+    if (FT_Load_Char(face, p->text[c], FT_LOAD_RENDER | FT_LOAD_TARGET_MONO)) continue;
+    FT_GlyphSlot g = face->glyph;
+    for (unsigned y = 0; y < g->bitmap.rows; y++) {
+      for (unsigned x = 0; x < g->bitmap.width; x++) {
+        if (!(g->bitmap.buffer[y * g->bitmap.pitch + x / 8] & (0x80 >> (x % 8)))) continue;
+        int px = pen + g->bitmap_left + x;
+        int py = ascender - g->bitmap_top + y;
+        if (px < 0 || px >= w || py < 0 || py >= h) continue;
+        pixels[py * row_size + px / 8] &= ~(1 << (px % 8));
+      }
+    }
+    pen += g->advance.x >> 6;
+  }
+  return blob;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 4) {
+    fprintf(stderr, "usage: %s FONT.ttf PHRASES_FILE OUT.bin\n", argv[0]);
+    return 2;
+  }
+
+  FT_Library library;
+  FT_Face face;
+  if (FT_Init_FreeType(&library) || FT_New_Face(library, argv[1], 0, &face)) {
+    fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+    return 1;
+  }
+
+  FILE *in = fopen(argv[2], "r");
+  if (!in) {
+    fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[2]);
+    return 1;
+  }
+  char line[256];
+  int phrases = 0;
+  int pool_size = 0;
+  while (phrases < MAX_PHRASES * 2 && fgets(line, sizeof(line), in)) {
+    Phrase *p = &s_phrases[phrases++];
+    int text_at;
+    line[strcspn(line, "\n")] = '\0';
+    if (sscanf(line, "%d %d %n", &p->index, &p->height, &text_at) != 2 || p->index < 0 || p->index >= MAX_PHRASES) {
+      fprintf(stderr, "%s: bad phrase line '%s'\n", argv[0], line);
+      return 1;
+    }
+    const unsigned char *c = (const unsigned char *)line + text_at;
+    for (p->length = 0; *c && p->length < 64; p->length++) c += utf8_next(c, &p->text[p->length]);
+    if (p->index + 1 > pool_size) pool_size = p->index + 1;
+  }
+  fclose(in);
+
+  for (int i = 0; i < phrases; i++) {
+    Phrase *p = &s_phrases[i];
+    int height = p->height;
+    if (height == BIG_FONT_SIZE && text_width(face, height, p) > MAX_WIDTH) height = SMALL_FONT_SIZE;
+    int ascender, descender;
+    measure(face, height, phrases, &ascender, &descender);
+    s_blobs[p->index * 2 + (p->height == BIG_FONT_SIZE)] = render(face, height, ascender, descender, p);
+  }
+
+  int count = pool_size * 2;
+  uint32_t offset = 4 + count * 8;
+  uint8_t header[4 + MAX_PHRASES * 2 * 8];
+  put16(header, count);
+  put16(header + 2, 0);
+  for (int i = 0; i < count; i++) {
+    put32(header + 4 + i * 8, s_blobs[i].size ? offset : 0);
+    put32(header + 8 + i * 8, s_blobs[i].size);
+    offset += (s_blobs[i].size + 3) & ~3u;
+  }
+
+  FILE *out = fopen(argv[3], "wb");
+  if (!out) {
+    fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[3]);
+    return 1;
+  }
+  static const uint8_t pad[3];
+  fwrite(header, 1, 4 + count * 8, out);
+  for (int i = 0; i < count; i++) {
+    fwrite(s_blobs[i].data, 1, s_blobs[i].size, out);
+    fwrite(pad, 1, -s_blobs[i].size & 3, out);
+    free(s_blobs[i].data);
+  }
+  fclose(out);
+
+  FT_Done_Face(face);
+  FT_Done_FreeType(library);
+  return 0;
+}
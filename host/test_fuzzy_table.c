@@ -0,0 +1,221 @@
+/*
+ * Checks the French phrases of the packed locale against the strcat
+ * cascade fuzzy_time() was before the phrase tables (tools/
+ * gen_fuzzy_table.py), kept below as it was, for the 1440 minutes of a
+ * day. Prints the mismatches, and exits with 1 when there are any.
+ */
+
+#include "pebble_host.h"
+#include "french_time.h"
+
+static const char* STR_HEURE = "heure";
+static const char* STR_H = " h.";
+static const char* STR_H2 = "h. ";
+static const char* STR_MOINS = "moins";
+static const char* STR_M = "- ";
+
+static const char* const HEURES[] = {
+  "minuit",
+  "une",
+  "deux",
+  "trois",
+  "quatre",
+  "cinq",
+  "six",
+  "sept",
+  "huit",
+  "neuf",
+  "dix",
+  "onze",
+  "midi"
+};
+
+static const char* const MINS[] = {
+  "pile !",
+  "cinq",
+  "dix",
+  "et quart",
+  "vingt",
+  "et demi",
+  "le quart",
+  "..."
+};
+
+static void cascade_fuzzy_time(struct tm* t, char* line1, char* line2, char* line3) {
+
+  int hours = t->tm_hour;
+  int minutes = t->tm_min;
+
+  strcpy(line1, "");
+  strcpy(line2, "");
+  strcpy(line3, "");
+
+
+  if (minutes >= 33) hours++;
+  if (hours >= 24) hours = 0;
+  if (hours > 12) hours -= 12;
+
+  strcat(line1, HEURES[hours]); // l'HEURE
+
+  if (minutes >= 0 && minutes < 3) {
+    if(hours > 0 && hours < 12) {
+      strcat(line2, STR_HEURE);
+      if (hours > 1) strcat(line2, "s");
+    }
+    if (minutes == 0) {
+      if(hours > 0 && hours < 12) {
+        strcat(line3, MINS[0]); // pile !
+      } else {
+        strcat(line2, MINS[0]); // pile !
+      }
+    }
+  }
+  else if (minutes < 8) {
+    if(hours > 0 && hours < 12) {
+      strcat(line2, STR_HEURE);
+      if (hours > 1) strcat(line2, "s");
+      strcat(line3, MINS[1]); // cinq
+    }
+    else strcat(line2, MINS[1]); // cinq
+  }
+  else if (minutes < 13) {
+    if(hours > 0 && hours < 12) {
+        strcat(line2, STR_HEURE);
+      if (hours > 1) strcat(line2, "s");
+      strcat(line3, MINS[2]); // dix
+    }
+    else strcat(line2, MINS[2]); // dix
+  }
+  else if (minutes < 18) {
+    if(hours > 0 && hours < 12) {
+        strcat(line2, STR_HEURE);
+      if (hours > 1) strcat(line2, "s");
+      strcat(line3, MINS[3]); // et quart
+    }
+    else strcat(line2, MINS[3]); // et quart
+  }
+  else if (minutes < 23) {
+    if(hours > 0 && hours < 12) {
+        strcat(line2, STR_HEURE);
+      if (hours > 1) strcat(line2, "s");
+      strcat(line3, MINS[4]); // vingt
+    }
+    else strcat(line2, MINS[4]); // vingt
+  }
+  else if (minutes < 28) {
+    if(hours > 0 && hours < 12) {
+      if(hours ==  4) {
+        strcat(line2, STR_H2);
+      } 
+      else {
+        strcat(line1, STR_H);
+      }
+    }
+    strcat(line2, MINS[4]); // vingt
+    strcat(line3, MINS[1]); // cinq
+  }
+  else if (minutes < 33) {
+    if(hours > 0 && hours < 12) {
+        strcat(line2, STR_HEURE);
+      if (hours > 1) strcat(line2, "s");
+      strcat(line3, MINS[5]); // et demi
+    }
+    else strcat(line2, MINS[5]); // et demi
+  }
+  else if (minutes < 38) {
+//    if(hours > 0 && hours < 12) strcat(line1, STR_H);
+    if(hours > 0 && hours < 12) {
+      if(hours ==  4) {
+        strcat(line2, STR_H2);
+      } 
+      else {
+        strcat(line1, STR_H);
+      }
+    }
+    strcat(line2, STR_M); // --
+    strcat(line2, MINS[4]); // vingt
+    strcat(line3, MINS[1]); // cinq
+  }
+  else if (minutes < 43) {
+    if(hours > 0 && hours < 12) {
+      if(hours ==  4) {
+        strcat(line2, STR_H2);
+      } 
+      else {
+        strcat(line1, STR_H);
+      }
+    }
+    strcat(line2, STR_MOINS); // moins
+    strcat(line3, MINS[4]); // vingt
+  }
+  else if (minutes < 48) {
+    if(hours > 0 && hours < 12) {
+      if(hours ==  4) {
+        strcat(line2, STR_H2);
+      } 
+      else {
+        strcat(line1, STR_H);
+      }
+    }
+    strcat(line2, STR_MOINS); // moins
+    strcat(line3, MINS[6]); // le quart
+  }
+  else if (minutes < 53) {
+    if(hours > 0 && hours < 12) {
+      if(hours ==  4) {
+        strcat(line2, STR_H2);
+      } 
+      else {
+        strcat(line1, STR_H);
+      }
+    }
+    strcat(line2, STR_MOINS); // moins
+    strcat(line3, MINS[2]); // dix
+  }
+  else if (minutes < 58) {
+    if(hours > 0 && hours < 12) {
+      if(hours ==  4) {
+        strcat(line2, STR_H2);
+      } 
+      else {
+        strcat(line1, STR_H);
+      }
+    }
+    strcat(line2, STR_MOINS); // moins
+    strcat(line3, MINS[1]); // cinq
+  }
+  else if (minutes >= 58) {
+    strcpy(line1, MINS[7]); // presque
+    strcat(line2, HEURES[hours]);
+    if(hours > 0 && hours < 12) {
+      strcat(line3, STR_HEURE);
+      if (hours > 1) strcat(line3, "s");
+    }
+  }
+}
+
+int main(void) {
+  if (!fuzzy_locale_load(LOCALE_FR)) {
+    printf("cannot load the French locale\n");
+    return 1;
+  }
+
+  int mismatches = 0;
+  struct tm t = { .tm_mday = 14, .tm_mon = 2, .tm_year = 115 };
+  for (int minute = 0; minute < 24 * 60; minute++) {
+    char expected[3][LINE_BUFFER_SIZE], line[3][LINE_BUFFER_SIZE];
+    t.tm_hour = minute / 60;
+    t.tm_min = minute % 60;
+    cascade_fuzzy_time(&t, expected[0], expected[1], expected[2]);
+    fuzzy_time(&t, line[0], line[1], line[2]);
+    for (int i = 0; i < 3; i++) {
+      if (strcmp(expected[i], line[i]) == 0) continue;
+      printf("%02d:%02d line %d: \"%s\", expected \"%s\"\n", t.tm_hour, t.tm_min, i + 1, line[i], expected[i]);
+      mismatches++;
+    }
+  }
+  fuzzy_locale_unload();
+
+  printf("%d minutes, %d mismatches\n", 24 * 60, mismatches);
+  return mismatches != 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * Golden test of fuzzy_time() and info_lines(), for every minute of 2015
+ * in each locale. The output only holds what a minute does not share with
+ * the others, which keeps host/test_golden.txt small:
+ *   - the phrases of the first day, each time they change;
+ *   - the date of each day;
+ *   - any minute whose phrases are not those of the same minute of the
+ *     first day, whose date is not that of its day, or whose time line is
+ *     not its "HH:MM -".
+ * The host build compares it with host/test_golden.txt; after an intended
+ * change, copy build/host/test_golden.txt over it.
+ */
+
+#include "pebble_host.h"
+#include "french_time.h"
+
+#define MINUTES_PER_DAY (24 * 60)
+#define DAYS 365
+
+typedef struct {
+  char line[3][LINE_BUFFER_SIZE];
+} Phrases;
+
+static Phrases s_first_day[MINUTES_PER_DAY];
+
+static bool same_phrases(const Phrases* a, const Phrases* b) {
+  return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+static void print_minute(int locale, const struct tm* t, const Phrases* p,
+                         const char* time_line, const char* date_line) {
+  printf("%d %04d-%02d-%02d %02d:%02d|%s|%s|%s|%s|%s\n", locale, t->tm_year + 1900,
+         t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min,
+         p->line[0], p->line[1], p->line[2], time_line, date_line);
+}
+
+int main(void) {
+  struct tm start = { .tm_year = 115, .tm_mday = 1 };
+  time_t t0 = timegm(&start);
+
+  for (int locale = 0; locale < LOCALE_COUNT; locale++) {
+    if (!fuzzy_locale_load(locale)) {
+      printf("%d: locale not loaded\n", locale);
+      return 1;
+    }
+    char date[LINE_BUFFER_SIZE] = "";
+    for (int m = 0; m < DAYS * MINUTES_PER_DAY; m++) {
+      time_t now = t0 + m * 60;
+      struct tm t = *gmtime(&now);
+      Phrases p;
+      char time_line[LINE_BUFFER_SIZE], date_line[LINE_BUFFER_SIZE], expected_time[16];
+      memset(&p, 0, sizeof(p));
+      fuzzy_time(&t, p.line[0], p.line[1], p.line[2]);
+      info_lines(&t, time_line, date_line);
+      snprintf(expected_time, sizeof(expected_time), "%02d:%02d -", t.tm_hour, t.tm_min);
+
+      int minute = m % MINUTES_PER_DAY;
+      if (minute == 0) {
+        strcpy(date, date_line);
+        printf("%d %04d-%02d-%02d|%s\n", locale, t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, date);
+      }
+      if (m < MINUTES_PER_DAY) {
+        if (m == 0 || !same_phrases(&p, &s_first_day[m - 1])) {
+          printf("%d %02d:%02d|%s|%s|%s\n", locale, t.tm_hour, t.tm_min,
+                 p.line[0], p.line[1], p.line[2]);
+        }
+        s_first_day[m] = p;
+      }
+      if (!same_phrases(&p, &s_first_day[minute]) || strcmp(date_line, date) != 0 ||
+          strcmp(time_line, expected_time) != 0) {
+        print_minute(locale, &t, &p, time_line, date_line);
+      }
+    }
+  }
+  fuzzy_locale_unload();
+  return 0;
+}
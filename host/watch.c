@@ -0,0 +1,103 @@
+/*
+ * Runs the watchface on the host and prints what is on screen after every
+ * minute (once transitions are over), e.g. to check the phrases around a given time:
+ *
+ *   watch 2015-03-14T07:55 20
+ *   watch --locale=de 2015-03-14T07:55 20
+ *
+ * It is built with tracing (trace.h): --trace prints the events the face
+ * recorded, after the last minute.
+ */
+
+#define _GNU_SOURCE
+#include "pebble_host.h"
+#include "french_time.h"
+#include "settings.h"
+#include "trace.h"
+
+static time_t s_start;
+static int s_minutes = 10;
+static bool s_trace;
+
+static void print_screen(void) {
+  char stamp[20];
+  time_t now = host_time(NULL);
+  strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M", gmtime(&now));
+  printf("%s |", stamp);
+
+  // Visible text layers, top to bottom
+  Layer *visible[16];
+  int count = 0;
+  Layer *root = window_get_root_layer(host_top_window());
+  for (Layer *layer = root->first_child; layer && count < 16; layer = layer->next_sibling) {
+    GRect frame = layer->frame;
+    bool on_screen = frame.origin.x > -frame.size.w && frame.origin.x < HOST_SCREEN_W;
+    if (layer->kind != HOST_LAYER_TEXT || !on_screen || layer->hidden) continue;
+    int i = count++;
+    for (; i > 0 && visible[i - 1]->frame.origin.y > frame.origin.y; i--) visible[i] = visible[i - 1];
+    visible[i] = layer;
+  }
+
+  for (int i = 0; i < count; i++) {
+    const char *text = ((TextLayer *)visible[i])->text;
+    printf(" %s |", text ? text : "");
+  }
+  printf("\n");
+}
+
+static void print_trace(void) {
+  TraceEvent events[256];
+  int count = trace_read(events, 256);
+  for (int i = 0; i < count; i++) {
+    char stamp[20];
+    time_t seconds = events[i].seconds;
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", gmtime(&seconds));
+    printf("%s.%03u %-10s %u\n", stamp, events[i].ms, trace_kind_name(events[i].kind), events[i].arg);
+  }
+}
+
+static void run(void) {
+  // Let the transitions settle before each print
+  host_run_for(1000);
+  print_screen();
+  for (int i = 0; i < s_minutes; i++) {
+    host_run_for(60 * 1000);
+    print_screen();
+  }
+  if (s_trace) print_trace();
+}
+
+static int usage(const char *name) {
+  fprintf(stderr, "usage: %s [--trace] [--locale=fr|en|de] [YYYY-MM-DDTHH:MM] [minutes]\n", name);
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  static const char *const locales[LOCALE_COUNT] = { "fr", "en", "de" };
+  struct tm start = { .tm_year = 115, .tm_mon = 2, .tm_mday = 14, .tm_hour = 7, .tm_min = 55 };
+
+  if (argc > 1 && strcmp(argv[1], "--trace") == 0) {
+    s_trace = true;
+    argv[1] = argv[0];
+    argc--;
+    argv++;
+  }
+  // The watchface reads its locale from persistent storage
+  if (argc > 1 && strncmp(argv[1], "--locale=", 9) == 0) {
+    int locale = 0;
+    while (locale < LOCALE_COUNT && strcmp(argv[1] + 9, locales[locale]) != 0) locale++;
+    if (locale == LOCALE_COUNT) return usage(argv[0]);
+    persist_write_int(PERSIST_KEY_LOCALE, locale);
+    argv[1] = argv[0];
+    argc--;
+    argv++;
+  }
+  if (argc > 1 && !strptime(argv[1], "%Y-%m-%dT%H:%M", &start)) return usage(argv[0]);
+  if (argc > 2) s_minutes = atoi(argv[2]);
+
+  s_start = timegm(&start);
+  host_clock_set(s_start);
+  host_set_event_loop(run);
+  pebble_main();
+  return 0;
+}
@@ -0,0 +1,18 @@
+#include "anim_policy.h"
+#include "settings.h"
+
+AnimPolicy anim_policy_select(AnimPolicy setting, BatteryChargeState state) {
+  if (setting > ANIM_POLICY_AUTO && setting < ANIM_POLICY_COUNT) return setting;
+
+  if (state.is_charging || state.charge_percent >= ANIM_FULL_MIN_PERCENT) return ANIM_POLICY_FULL;
+  if (state.charge_percent >= ANIM_REDUCED_MIN_PERCENT) return ANIM_POLICY_REDUCED;
+  return ANIM_POLICY_NONE;
+}
+
+uint32_t anim_policy_duration(AnimPolicy mode) {
+  switch (mode) {
+    case ANIM_POLICY_REDUCED: return ANIM_REDUCED_DURATION;
+    case ANIM_POLICY_NONE: return 0;
+    default: return ANIM_FULL_DURATION;
+  }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "pebble.h"
+
+/*
+ * How the fuzzy time lines change: the full slide, a shorter one (fewer
+ * frames) or an instant swap. In the automatic setting the mode follows
+ * the battery state, so transitions cost less as the battery runs down
+ * (thresholds in settings.h).
+ */
+typedef enum {
+  ANIM_POLICY_AUTO,
+  ANIM_POLICY_FULL,
+  ANIM_POLICY_REDUCED,
+  ANIM_POLICY_NONE,
+  ANIM_POLICY_COUNT
+} AnimPolicy;
+
+// Mode to use for setting in battery state state, never ANIM_POLICY_AUTO
+// (an unknown setting is taken as automatic)
+AnimPolicy anim_policy_select(AnimPolicy setting, BatteryChargeState state);
+
+// Length of a transition in mode, 0 for an instant swap
+uint32_t anim_policy_duration(AnimPolicy mode);
@@ -0,0 +1,125 @@
+#include "canvas.h"
+#include "settings.h"
+
+#if CANVAS_LAYER
+
+// Every text and bitmap of the face
+#define CANVAS_ITEMS 11
+
+static CanvasItem s_items[CANVAS_ITEMS];
+static CanvasItem* s_order[CANVAS_ITEMS];  // in drawing order
+static int s_count;
+static int s_added;
+static Layer* s_layer;
+
+static void draw_bitmap(GContext* ctx, const CanvasItem* item) {
+  // placed in the frame as a BitmapLayer does
+  GSize size = item->bitmap->bounds.size;
+  GAlign align = item->alignment;
+  int dx = item->frame.size.w - size.w;
+  int dy = item->frame.size.h - size.h;
+  int x = (align == GAlignTopLeft || align == GAlignLeft || align == GAlignBottomLeft) ? 0 :
+          (align == GAlignTopRight || align == GAlignRight || align == GAlignBottomRight) ? dx : dx / 2;
+  int y = (align == GAlignTopLeft || align == GAlignTop || align == GAlignTopRight) ? 0 :
+          (align == GAlignBottomLeft || align == GAlignBottom || align == GAlignBottomRight) ? dy : dy / 2;
+  if (size.w > item->frame.size.w) size.w = item->frame.size.w;
+  if (size.h > item->frame.size.h) size.h = item->frame.size.h;
+
+  graphics_context_set_compositing_mode(ctx, item->compositing_mode);
+  graphics_draw_bitmap_in_rect(ctx, item->bitmap,
+                               (GRect) { { item->frame.origin.x + x, item->frame.origin.y + y }, size });
+}
+
+static void canvas_update(Layer* layer, GContext* ctx) {
+  graphics_context_set_text_color(ctx, GColorBlack);
+  for (int i = 0; i < s_added; i++) {
+    const CanvasItem* item = s_order[i];
+    GRect frame = item->frame;
+    // lines waiting off screen for their next slide
+    if (item->hidden || frame.origin.x >= 144 || frame.origin.x + frame.size.w <= 0) continue;
+
+    if (item->text && item->text[0]) {
+      graphics_draw_text(ctx, item->text, item->font, frame, GTextOverflowModeWordWrap, item->text_alignment, NULL);
+    }
+    if (item->bitmap) draw_bitmap(ctx, item);
+  }
+}
+
+Layer* canvas_create(Layer* parent) {
+  s_layer = layer_create(layer_get_bounds(parent));
+  layer_set_update_proc(s_layer, canvas_update);
+  layer_add_child(parent, s_layer);
+  return s_layer;
+}
+
+void canvas_destroy(void) {
+  layer_destroy(s_layer);
+  s_layer = NULL;
+  s_count = s_added = 0;
+}
+
+static void mark_dirty(void) {
+  if (s_layer) layer_mark_dirty(s_layer);
+}
+
+CanvasItem* canvas_item_create(GRect frame) {
+  if (s_count == CANVAS_ITEMS) return NULL;
+  CanvasItem* item = &s_items[s_count++];
+  *item = (CanvasItem) { .frame = frame, .compositing_mode = GCompOpAssign, .alignment = GAlignCenter };
+  return item;
+}
+
+void canvas_add(CanvasItem* item) {
+  s_order[s_added++] = item;
+  mark_dirty();
+}
+
+void canvas_item_set_text(CanvasItem* item, const char* text) {
+  item->text = text;
+  mark_dirty();
+}
+
+const char* canvas_item_get_text(CanvasItem* item) {
+  return item->text;
+}
+
+void canvas_item_set_font(CanvasItem* item, GFont font) {
+  if (item->font == font) return;
+  item->font = font;
+  mark_dirty();
+}
+
+void canvas_item_set_text_alignment(CanvasItem* item, GTextAlignment alignment) {
+  item->text_alignment = alignment;
+}
+
+void canvas_item_set_bitmap(CanvasItem* item, const GBitmap* bitmap) {
+  item->bitmap = bitmap;
+  mark_dirty();
+}
+
+void canvas_item_set_alignment(CanvasItem* item, GAlign alignment) {
+  item->alignment = alignment;
+}
+
+void canvas_item_set_compositing_mode(CanvasItem* item, GCompOp mode) {
+  item->compositing_mode = mode;
+}
+
+void canvas_item_set_frame(CanvasItem* item, GRect frame) {
+  if (memcmp(&item->frame, &frame, sizeof(GRect)) == 0) return;
+  item->frame = frame;
+  mark_dirty();
+}
+
+GRect canvas_item_get_frame(CanvasItem* item) {
+  return item->frame;
+}
+
+void canvas_item_set_hidden(CanvasItem* item, bool hidden) {
+  if (item->hidden == hidden) return;
+  item->hidden = hidden;
+  mark_dirty();
+}
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "pebble.h"
+
+/*
+ * The CANVAS_LAYER mode: one layer draws every text and bitmap of the face
+ * from its update_proc, in place of a TextLayer or BitmapLayer each. The
+ * items are static and mark the canvas dirty when they change, so the
+ * heap holds a single layer and a redraw traverses a single layer.
+ */
+typedef struct {
+  GRect frame;
+  bool hidden;
+  const char* text;
+  GFont font;
+  GTextAlignment text_alignment;
+  const GBitmap* bitmap;
+  GAlign alignment;
+  GCompOp compositing_mode;
+} CanvasItem;
+
+// The layer drawing the items, added to parent
+Layer* canvas_create(Layer* parent);
+// Destroys the layer and forgets the items
+void canvas_destroy(void);
+
+// A blank item, NULL when all CANVAS_ITEMS are in use
+CanvasItem* canvas_item_create(GRect frame);
+// Draws item after the items added before it, like layer_add_child()
+void canvas_add(CanvasItem* item);
+
+// As their text_layer_, bitmap_layer_ and layer_ counterparts
+void canvas_item_set_text(CanvasItem* item, const char* text);
+const char* canvas_item_get_text(CanvasItem* item);
+void canvas_item_set_font(CanvasItem* item, GFont font);
+void canvas_item_set_text_alignment(CanvasItem* item, GTextAlignment alignment);
+void canvas_item_set_bitmap(CanvasItem* item, const GBitmap* bitmap);
+void canvas_item_set_alignment(CanvasItem* item, GAlign alignment);
+void canvas_item_set_compositing_mode(CanvasItem* item, GCompOp mode);
+void canvas_item_set_frame(CanvasItem* item, GRect frame);
+GRect canvas_item_get_frame(CanvasItem* item);
+void canvas_item_set_hidden(CanvasItem* item, bool hidden);
@@ -0,0 +1,25 @@
+#include "easing.h"
+
+// Table points, the curve is linear between them (within 0.04 px on a
+// 144 px slide)
+#define EASING_SHIFT 11
+#define EASING_STEPS ((ANIMATION_NORMALIZED_MAX + 1) >> EASING_SHIFT)
+
+static uint16_t s_ease_out[EASING_STEPS + 1];
+
+void easing_init(void) {
+  if (s_ease_out[EASING_STEPS]) return;
+  for (int i = 0; i <= EASING_STEPS; i++) {
+    // 1 - (1 - u)^2, in 16 bit fixed point
+    uint32_t u = (uint32_t)i << EASING_SHIFT;
+    uint32_t eased = (uint64_t)u * (2 * (ANIMATION_NORMALIZED_MAX + 1) - u) >> 16;
+    s_ease_out[i] = eased > ANIMATION_NORMALIZED_MAX ? ANIMATION_NORMALIZED_MAX : eased;
+  }
+}
+
+uint32_t easing_out(uint32_t progress) {
+  if (progress >= ANIMATION_NORMALIZED_MAX) return ANIMATION_NORMALIZED_MAX;
+  uint32_t i = progress >> EASING_SHIFT;
+  uint32_t fraction = progress & ((1 << EASING_SHIFT) - 1);
+  return s_ease_out[i] + ((s_ease_out[i + 1] - s_ease_out[i]) * fraction >> EASING_SHIFT);
+}
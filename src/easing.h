@@ -0,0 +1,15 @@
+#pragma once
+
+#include "pebble.h"
+
+/*
+ * Ease-out curve of the line slides, as a fixed-point lookup table filled
+ * once: the transition runs on the linear curve and maps its progress
+ * through the table, a lookup and a multiply per frame.
+ */
+
+// Fills the table, once
+void easing_init(void);
+
+// Eased progress, both from 0 to ANIMATION_NORMALIZED_MAX
+uint32_t easing_out(uint32_t progress);
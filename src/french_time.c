@@ -1,243 +1,161 @@
 #include "french_time.h"
-
-static const char* STR_HEURE = "heure";
-static const char* STR_H = " h.";
-static const char* STR_H2 = "h. ";
-static const char* STR_MOINS = "moins";
-static const char* STR_M = "- ";
-
-static const char* const HEURES[] = {
-  "minuit",
-  "une",
-  "deux",
-  "trois",
-  "quatre",
-  "cinq",
-  "six",
-  "sept",
-  "huit",
-  "neuf",
-  "dix",
-  "onze",
-  "midi"
+#include "line_builder.h"
+
+// Layout of a LOCALE_* resource, see tools/gen_fuzzy_table.py. Fields
+// other than the offsets are indexes into the locale's strings.
+typedef struct {
+  uint8_t version;
+  uint8_t hours;
+  uint8_t buckets;
+  uint8_t next_hour_minute;
+  uint16_t phrase_base;
+  uint16_t strings;
+  uint8_t string_count;
+  uint8_t date_format;
+  uint8_t days[7];
+  uint8_t months[12];
+  uint8_t bucket_of_minute[60];
+  uint8_t minutes_to_next_bucket[60];
+  uint8_t table[];  // [hours][buckets][3]
+} FuzzyLocale;
+
+#define FUZZY_LOCALE_VERSION 1
+
+static const uint32_t LOCALE_RESOURCES[LOCALE_COUNT] = {
+  RESOURCE_ID_LOCALE_FR,
+  RESOURCE_ID_LOCALE_EN,
+  RESOURCE_ID_LOCALE_DE
 };
 
-static const char* const MINS[] = {
-  "pile !",
-  "cinq",
-  "dix",
-  "et quart",
-  "vingt",
-  "et demi",
-  "le quart",
-  "..."
-};
+static FuzzyLocale* s_locale;
+static const uint16_t* s_strings;
 
-static const char* const JOURS[] = {
-  "Dimanche",
-  "Lundi",
-  "Mardi",
-  "Mercredi",
-  "Jeudi",
-  "Vendredi",
-  "Samedi"
-};
+bool fuzzy_locale_load(int locale) {
 
-static const char* const MOIS[] = {
-  "Jan.",
-  "Fév.",
-  "Mars",
-  "Avril",
-  "Mai",
-  "Juin",
-  "Juil.",
-  "Août",
-  "Sep.",
-  "Oct.",
-  "Nov.",
-  "Déc."
-};
+  if (locale < 0 || locale >= LOCALE_COUNT) return false;
+  ResHandle h = resource_get_handle(LOCALE_RESOURCES[locale]);
+  size_t size = resource_size(h);
+  FuzzyLocale* data = malloc(size);
+  if (!data) return false;
 
+  if (resource_load(h, (uint8_t*)data, size) != size || data->version != FUZZY_LOCALE_VERSION) {
+    free(data);
+    return false;
+  }
+  fuzzy_locale_unload();
+  s_locale = data;
+  s_strings = (const uint16_t*)((const uint8_t*)data + data->strings);
+  return true;
+}
 
+void fuzzy_locale_unload(void) {
+  free(s_locale);
+  s_locale = NULL;
+  s_strings = NULL;
+}
 
-void fuzzy_time(struct tm* t, char* line1, char* line2, char* line3) {
+static inline const char* locale_string(int index) {
+  return (const char*)s_locale + s_strings[index];
+}
+
+int fuzzy_time_key(struct tm* t) {
 
   int hours = t->tm_hour;
   int minutes = t->tm_min;
 
-  strcpy(line1, "");
-  strcpy(line2, "");
-  strcpy(line3, "");
-
-
-  if (minutes >= 33) hours++;
+  if (minutes >= s_locale->next_hour_minute) hours++;
   if (hours >= 24) hours = 0;
   if (hours > 12) hours -= 12;
 
-  strcat(line1, HEURES[hours]); // l'HEURE
+  return hours * s_locale->buckets + s_locale->bucket_of_minute[minutes];
+}
 
-  if (minutes >= 0 && minutes < 3) {
-    if(hours > 0 && hours < 12) {
-      strcat(line2, STR_HEURE);
-      if (hours > 1) strcat(line2, "s");
-    }
-    if (minutes == 0) {
-      if(hours > 0 && hours < 12) {
-        strcat(line3, MINS[0]); // pile !
-      } else {
-        strcat(line2, MINS[0]); // pile !
-      }
-    }
-  }
-  else if (minutes < 8) {
-    if(hours > 0 && hours < 12) {
-      strcat(line2, STR_HEURE);
-      if (hours > 1) strcat(line2, "s");
-      strcat(line3, MINS[1]); // cinq
-    }
-    else strcat(line2, MINS[1]); // cinq
-  }
-  else if (minutes < 13) {
-    if(hours > 0 && hours < 12) {
-        strcat(line2, STR_HEURE);
-      if (hours > 1) strcat(line2, "s");
-      strcat(line3, MINS[2]); // dix
-    }
-    else strcat(line2, MINS[2]); // dix
-  }
-  else if (minutes < 18) {
-    if(hours > 0 && hours < 12) {
-        strcat(line2, STR_HEURE);
-      if (hours > 1) strcat(line2, "s");
-      strcat(line3, MINS[3]); // et quart
-    }
-    else strcat(line2, MINS[3]); // et quart
-  }
-  else if (minutes < 23) {
-    if(hours > 0 && hours < 12) {
-        strcat(line2, STR_HEURE);
-      if (hours > 1) strcat(line2, "s");
-      strcat(line3, MINS[4]); // vingt
-    }
-    else strcat(line2, MINS[4]); // vingt
-  }
-  else if (minutes < 28) {
-    if(hours > 0 && hours < 12) {
-      if(hours ==  4) {
-        strcat(line2, STR_H2);
-      } 
-      else {
-        strcat(line1, STR_H);
-      }
-    }
-    strcat(line2, MINS[4]); // vingt
-    strcat(line3, MINS[1]); // cinq
-  }
-  else if (minutes < 33) {
-    if(hours > 0 && hours < 12) {
-        strcat(line2, STR_HEURE);
-      if (hours > 1) strcat(line2, "s");
-      strcat(line3, MINS[5]); // et demi
-    }
-    else strcat(line2, MINS[5]); // et demi
-  }
-  else if (minutes < 38) {
-//    if(hours > 0 && hours < 12) strcat(line1, STR_H);
-    if(hours > 0 && hours < 12) {
-      if(hours ==  4) {
-        strcat(line2, STR_H2);
-      } 
-      else {
-        strcat(line1, STR_H);
-      }
-    }
-    strcat(line2, STR_M); // --
-    strcat(line2, MINS[4]); // vingt
-    strcat(line3, MINS[1]); // cinq
-  }
-  else if (minutes < 43) {
-    if(hours > 0 && hours < 12) {
-      if(hours ==  4) {
-        strcat(line2, STR_H2);
-      } 
-      else {
-        strcat(line1, STR_H);
-      }
-    }
-    strcat(line2, STR_MOINS); // moins
-    strcat(line3, MINS[4]); // vingt
-  }
-  else if (minutes < 48) {
-    if(hours > 0 && hours < 12) {
-      if(hours ==  4) {
-        strcat(line2, STR_H2);
-      } 
-      else {
-        strcat(line1, STR_H);
-      }
-    }
-    strcat(line2, STR_MOINS); // moins
-    strcat(line3, MINS[6]); // le quart
-  }
-  else if (minutes < 53) {
-    if(hours > 0 && hours < 12) {
-      if(hours ==  4) {
-        strcat(line2, STR_H2);
-      } 
-      else {
-        strcat(line1, STR_H);
-      }
+void fuzzy_time_lookup(struct tm* t, const char** line1, const char** line2, const char** line3) {
+
+  const uint8_t* phrase = &s_locale->table[fuzzy_time_key(t) * 3];
+
+  *line1 = locale_string(phrase[0]);
+  *line2 = locale_string(phrase[1]);
+  *line3 = locale_string(phrase[2]);
+}
+
+void fuzzy_clock_init(FuzzyClock* clock) {
+  clock->key = -1;
+  clock->line[0] = clock->line[1] = clock->line[2] = locale_string(0);
+}
+
+int fuzzy_clock_update(FuzzyClock* clock, struct tm* t) {
+
+  int key = fuzzy_time_key(t);
+  if (key == clock->key) return 0;
+  clock->key = key;
+
+  // phrases are pooled, so comparing pointers is comparing strings
+  const uint8_t* phrase = &s_locale->table[key * 3];
+  int changed = 0;
+  for (int i = 0; i < 3; i++) {
+    const char* line = locale_string(phrase[i]);
+    if (line != clock->line[i]) {
+      clock->line[i] = line;
+      changed |= 1 << i;
     }
-    strcat(line2, STR_MOINS); // moins
-    strcat(line3, MINS[2]); // dix
   }
-  else if (minutes < 58) {
-    if(hours > 0 && hours < 12) {
-      if(hours ==  4) {
-        strcat(line2, STR_H2);
-      } 
-      else {
-        strcat(line1, STR_H);
-      }
-    }
-    strcat(line2, STR_MOINS); // moins
-    strcat(line3, MINS[1]); // cinq
+  return changed;
+}
+
+int fuzzy_phrase_index(const char* phrase) {
+  if (phrase == locale_string(0)) return 0;
+  for (int i = 1; i < s_locale->string_count; i++) {
+    if (locale_string(i) == phrase) return s_locale->phrase_base + i;
   }
-  else if (minutes >= 58) {
-    strcpy(line1, MINS[7]); // presque
-    strcat(line2, HEURES[hours]);
-    if(hours > 0 && hours < 12) {
-      strcat(line3, STR_HEURE);
-      if (hours > 1) strcat(line3, "s");
-    }
+  return -1;
+}
+
+int fuzzy_time_minutes_to_change(struct tm* t) {
+  return s_locale->minutes_to_next_bucket[t->tm_min];
+}
+
+void fuzzy_time(struct tm* t, char* line1, char* line2, char* line3) {
+
+  const char* str[3];
+  char* line[3] = { line1, line2, line3 };
+  LineBuilder b;
+
+  fuzzy_time_lookup(t, &str[0], &str[1], &str[2]);
+
+  for (int i = 0; i < 3; i++) {
+    line_builder_init(&b, line[i], LINE_BUFFER_SIZE);
+    line_append_str(&b, str[i]);
+    line_builder_end(&b);
   }
 }
 
 void info_lines(struct tm* t, char* line1, char* line2) {
 
-  char wday[LINE_BUFFER_SIZE];
-  char mday[LINE_BUFFER_SIZE];
-  char mon[LINE_BUFFER_SIZE];
-
-  strcpy(line1, "");
-  strcpy(line2, "");
-
-//  string_format_time(line1, LINE_BUFFER_SIZE, "%A • %e %b", t);
-  mini_snprintf(wday, LINE_BUFFER_SIZE, "%s", JOURS[t->tm_wday]);
-  mini_snprintf(mday, LINE_BUFFER_SIZE, "%d", t->tm_mday);
-  mini_snprintf(mon, LINE_BUFFER_SIZE, "%s", MOIS[t->tm_mon]);
-//  strcat(line1, wday);
-//  strcat(line1, " ");
-//  strcat(line1, mday);
-//  strcat(line1, " ");
-//  strcat(line1, mon);
-
-//  strftime(line2, LINE_BUFFER_SIZE, "s-%W • j-%j • %H%M", t);
-
-  strftime(line2, LINE_BUFFER_SIZE, "%H:%M - ", t);
-  strcat(line2, wday);
-  strcat(line2, " ");
-  strcat(line2, mday);
-  strcat(line2, " ");
-  strcat(line2, mon);
+  LineBuilder b;
+
+  // time part, changes every minute: "%H:%M -", the separator going with
+  // the time when it is hidden
+  line_builder_init(&b, line1, LINE_BUFFER_SIZE);
+  line_append_u2(&b, t->tm_hour);
+  line_append_char(&b, ':');
+  line_append_u2(&b, t->tm_min);
+  line_append_str(&b, " -");
+  line_builder_end(&b);
+
+  // date part, changes once a day: "Jour 1 Mois" in French
+  line_builder_init(&b, line2, LINE_BUFFER_SIZE);
+  for (const char* f = locale_string(s_locale->date_format); *f; f++) {
+    if (*f != '%' || !f[1]) {
+      line_append_char(&b, *f);
+      continue;
+    }
+    switch (*++f) {
+      case 'A': line_append_str(&b, locale_string(s_locale->days[t->tm_wday])); break;
+      case 'B': line_append_str(&b, locale_string(s_locale->months[t->tm_mon])); break;
+      case 'd': line_append_u(&b, t->tm_mday); break;
+      default: line_append_char(&b, *f);
+    }
+  }
+  line_builder_end(&b);
 }
@@ -6,6 +6,52 @@
 
 #define LINE_BUFFER_SIZE 50
 
+// Locales packed by tools/gen_fuzzy_table.py, in its LOCALES order
+typedef enum {
+  LOCALE_FR,
+  LOCALE_EN,
+  LOCALE_DE,
+  LOCALE_COUNT
+} FuzzyLocaleId;
+
+// Loads the phrases and rules of locale (its LOCALE_* resource) into a
+// single heap buffer, replacing the current one. Every function below
+// needs a loaded locale.
+bool fuzzy_locale_load(int locale);
+void fuzzy_locale_unload(void);
+
+// Returns the three fuzzy time lines as pointers into the string pool of
+// the loaded locale (nothing is copied).
+void fuzzy_time_lookup(struct tm* t, const char** line1, const char** line2, const char** line3);
+
+// (hour, bucket) key of the phrase shown at t, in the loaded locale
+int fuzzy_time_key(struct tm* t);
+
+#define FUZZY_LINE1 (1 << 0)
+#define FUZZY_LINE2 (1 << 1)
+#define FUZZY_LINE3 (1 << 2)
+
+// Remembers the phrase currently shown, so that an update costs a single
+// key comparison when the fuzzy time did not change.
+typedef struct {
+  int key;
+  const char* line[3];
+} FuzzyClock;
+
+void fuzzy_clock_init(FuzzyClock* clock);
+
+// Moves clock to t, returns the FUZZY_LINE* mask of the lines that changed
+int fuzzy_clock_update(FuzzyClock* clock, struct tm* t);
+
+// PHRASE_BITMAPS id of a line returned above, 0 for "", -1 for other strings
+int fuzzy_phrase_index(const char* phrase);
+
+// Minutes from the start of t's minute until the fuzzy time may change
+int fuzzy_time_minutes_to_change(struct tm* t);
+
 void fuzzy_time(struct tm* t, char* str_line1, char* str_line2, char* str_line3);
 
+// Bottom bar: str_line1 gets the "%H:%M -" time, str_line2 the date in the
+// locale's format ("Jour 1 Mois"), so they can be drawn (and redrawn)
+// separately, and the date shown alone.
 void info_lines(struct tm* t, char* str_line1, char* str_line2);
\ No newline at end of file
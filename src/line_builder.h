@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+
+/*
+ * Cursor based string builder: appends go straight to the end of the text,
+ * so building a line is one linear pass with no rescans (as strcat does)
+ * and no scratch buffers. Appends are bounded by the buffer size and
+ * silently truncated; line_builder_end() NUL terminates the text.
+ */
+typedef struct {
+  char* cur;
+  char* end;  // last byte of the buffer, kept for the terminating NUL
+} LineBuilder;
+
+static inline void line_builder_init(LineBuilder* b, char* buffer, size_t size) {
+  b->cur = buffer;
+  b->end = buffer + size - 1;
+}
+
+static inline void line_append_char(LineBuilder* b, char c) {
+  if (b->cur < b->end) *b->cur++ = c;
+}
+
+static inline void line_append_str(LineBuilder* b, const char* s) {
+  while (*s && b->cur < b->end) *b->cur++ = *s++;
+}
+
+// Two digits, zero padded ("%02u")
+static inline void line_append_u2(LineBuilder* b, unsigned int value) {
+  line_append_char(b, '0' + value / 10 % 10);
+  line_append_char(b, '0' + value % 10);
+}
+
+// Every digit, not padded ("%u")
+static inline void line_append_u(LineBuilder* b, unsigned int value) {
+  char digits[10];
+  int n = 0;
+  do {
+    digits[n++] = '0' + value % 10;
+    value /= 10;
+  } while (value);
+  while (n) line_append_char(b, digits[--n]);
+}
+
+static inline void line_builder_end(LineBuilder* b) {
+  *b->cur = '\0';
+}
@@ -1,34 +1,81 @@
 #include <pebble.h>
   
+#include "anim_policy.h"
+#include "canvas.h"
+#include "easing.h"
 #include "french_time.h"
+#include "phrase_bitmaps.h"
+#include "settings.h"
+#include "status_events.h"
+#include "status_icons.h"
+#include "text_metrics.h"
+#include "trace.h"
 
-#define ANIMATION_DURATION 800
 #define LINE_BUFFER_SIZE 50
 #define WINDOW_NAME "fuzzy_french_plus"
 
 static Window *s_main_window;
+static bool s_low_wake;
+static AnimPolicy s_anim_setting;
+static AnimPolicy s_anim_mode;
+static int s_locale;
+static AppTimer *s_bucket_timer;
 
 static GFont s_time_font;
 static GFont s_time_font_big;
-static GBitmap *s_bitmap_bt_on;
-static GBitmap *s_bitmap_bt_off;
-static GBitmap *s_bitmap_charging;
+#if !PHRASE_BITMAPS
+static bool s_custom_fonts;
+#endif
+static AppTimer *s_startup_timer;
+
+// The texts and icons are layers, or items drawn by one canvas layer
+#if CANVAS_LAYER
+typedef CanvasItem UiText;
+typedef CanvasItem UiBitmap;
+#define ui_add(root, ui) canvas_add(ui)
+#define ui_set_text canvas_item_set_text
+#define ui_get_text canvas_item_get_text
+#define ui_set_font canvas_item_set_font
+#define ui_set_bitmap canvas_item_set_bitmap
+#define ui_set_frame canvas_item_set_frame
+#define ui_get_frame canvas_item_get_frame
+#define ui_set_hidden canvas_item_set_hidden
+#else
+typedef TextLayer UiText;
+typedef BitmapLayer UiBitmap;
+#define ui_add(root, ui) layer_add_child((root), (Layer *)(ui))
+#define ui_set_text text_layer_set_text
+#define ui_get_text text_layer_get_text
+#define ui_set_font text_layer_set_font
+#define ui_set_bitmap bitmap_layer_set_bitmap
+#define ui_set_frame(ui, frame) layer_set_frame((Layer *)(ui), (frame))
+#define ui_get_frame(ui) layer_get_frame((Layer *)(ui))
+#define ui_set_hidden(ui, hidden) layer_set_hidden((Layer *)(ui), (hidden))
+#endif
+
+// The fuzzy time lines are text, or their pre-rendered bitmaps
+#if PHRASE_BITMAPS
+typedef UiBitmap LineLayer;
+#else
+typedef UiText LineLayer;
+#endif
 
 typedef struct {
-  TextLayer *layer[2];
+  LineLayer *layer[2];
+#if PHRASE_BITMAPS
+  GBitmap *bitmap[2];
+#endif
   GRect out_rect;
-  bool busy_animating_in;
-  bool busy_animating_out;
-  PropertyAnimation *animate_out;
-  PropertyAnimation *animate_in;
+  bool moving;
+  uint16_t start;     // progress of the transition the slide starts at
+  int16_t from_x[2];
+  int16_t to_x[2];
+  const char *text;
 } TextLine;
 
 typedef struct {
-  char line1[LINE_BUFFER_SIZE];
-  char line2[LINE_BUFFER_SIZE];
-  char line3[LINE_BUFFER_SIZE];
-  char topline[LINE_BUFFER_SIZE];
-  char bottomline[LINE_BUFFER_SIZE];
+  char bottomtime[LINE_BUFFER_SIZE];
+  char bottomdate[LINE_BUFFER_SIZE];
 } TheTime;
 
 static TextLine line1;
@@ -36,13 +83,36 @@ static TextLine line2;
 static TextLine line3;
 //static TextLine topbar;
 //static TextLine bottombar;
-static TextLayer *batterylayer;
-static TextLayer *bottomlayer;
-static BitmapLayer *s_bt_bitmap_layer;
-static BitmapLayer *s_ch_bitmap_layer;
+static UiText *batterylayer;
+static UiText *bottomtimelayer;
+static UiText *bottomdatelayer;
+static UiBitmap *s_bt_bitmap_layer;
+static UiBitmap *s_ch_bitmap_layer;
+
+// One animation slides every changing line, see updateLayer()
+static Animation *s_transition;
+
+// What the face showed when it exited, saved in PERSIST_KEY_DISPLAY: on
+// the next launch the lines are shown at once, without sliding in, while
+// the fuzzy time is the same. A record of another version is ignored.
+#define DISPLAY_STATE_VERSION 1
+#define DISPLAY_CONNECTED (1 << 0)
+
+typedef struct {
+  uint8_t version;
+  uint8_t locale;
+  uint8_t flags;
+  uint8_t reserved;
+  int16_t fuzzy_key;
+} DisplayState;
+
+static DisplayState s_display_state;
+// The Bluetooth icon shows a connection
+static bool s_connected;
 
 static TheTime cur_time;
 static TheTime new_time;
+static FuzzyClock fuzzy_clock;
 
 const int line1_y = 10;
 const int line2_y = 60;
@@ -50,114 +120,244 @@ const int line3_y = 100;
 
 
 
-void animateOutStoppedHandler(Animation *animation, bool finished, void *context) {
-  TextLine* line = (TextLine*)context;
-  line->busy_animating_out = false;
-  
-  // Free the animation
-  property_animation_destroy(line->animate_out);
+// Left aligned text, drawn over what is below
+static UiText* createText(GRect frame, GFont font) {
+#if CANVAS_LAYER
+  CanvasItem *item = canvas_item_create(frame);
+  canvas_item_set_font(item, font);
+  canvas_item_set_text_alignment(item, GTextAlignmentLeft);
+  return item;
+#else
+  TextLayer *layer = text_layer_create(frame);
+  text_layer_set_background_color(layer, GColorClear);
+  text_layer_set_font(layer, font);
+  text_layer_set_text_alignment(layer, GTextAlignmentLeft);
+//  text_layer_set_overflow_mode (layer, GTextOverflowModeWordWrap);
+  return layer;
+#endif
+}
 
-  if(finished) {
-    // restore origin
-    GRect from_frame_out = layer_get_frame(text_layer_get_layer(line->layer[0]));
-    from_frame_out.origin.x = 0;
-    layer_set_frame(text_layer_get_layer(line->layer[0]), from_frame_out);
+static UiBitmap* createBitmap(GRect frame, GAlign alignment, GCompOp mode) {
+#if CANVAS_LAYER
+  CanvasItem *item = canvas_item_create(frame);
+  canvas_item_set_alignment(item, alignment);
+  canvas_item_set_compositing_mode(item, mode);
+  return item;
+#else
+  BitmapLayer *layer = bitmap_layer_create(frame);
+  bitmap_layer_set_alignment(layer, alignment);
+  bitmap_layer_set_compositing_mode(layer, mode);
+  return layer;
+#endif
+}
+
+static void destroyText(UiText *text) {
+#if !CANVAS_LAYER
+  text_layer_destroy(text);
+#endif
+}
+
+static void destroyBitmap(UiBitmap *bitmap) {
+#if !CANVAS_LAYER
+  bitmap_layer_destroy(bitmap);
+#endif
+}
+
+static LineLayer* createLineLayer(GRect frame, GFont font) {
+#if PHRASE_BITMAPS
+  // white around the glyphs must not erase the lines it slides over
+  return createBitmap(frame, GAlignTopLeft, GCompOpAnd);
+#else
+  return createText(frame, font);
+#endif
+}
+
+static void setLineText(TextLine *line, int i, const char *text) {
+#if PHRASE_BITMAPS
+  // acquired first, so a bitmap shown by both layers is not read again
+  GBitmap *old = line->bitmap[i];
+  line->bitmap[i] = phrase_bitmap_acquire(text, line->out_rect.origin.y == line1_y);
+  ui_set_bitmap(line->layer[i], line->bitmap[i]);
+  phrase_bitmap_release(old);
+#else
+  // the first line is in the big font, unless the text does not fit in it
+  if (line->out_rect.origin.y == line1_y && text) {
+    ui_set_font(line->layer[i], text_width(text, s_time_font_big) <= 144 ? s_time_font_big : s_time_font);
   }
+  ui_set_text(line->layer[i], text);
+#endif
 }
 
-void animateInStoppedHandler(Animation *animation, bool finished, void *context) {
-  TextLine* line = (TextLine*)context;
-  line->busy_animating_in = false;
-  
-  // Free the animation
-  property_animation_destroy(line->animate_in);
-  
-  if(finished) {
-    // restore origin
-    GRect from_frame_in = layer_get_frame(text_layer_get_layer(line->layer[1]));
-    from_frame_in.origin.x = 0;
+static void destroyLineLayers(TextLine *line) {
+  for (int i = 0; i < 2; i++) {
+#if PHRASE_BITMAPS
+    destroyBitmap(line->layer[i]);
+    phrase_bitmap_release(line->bitmap[i]);
+    line->bitmap[i] = NULL;
+#else
+    destroyText(line->layer[i]);
+#endif
+  }
+}
+
+static int16_t interpolate(int16_t from, int16_t to, uint32_t distance) {
+  return from + (int32_t)(to - from) * (int32_t)distance / ANIMATION_NORMALIZED_MAX;
+}
+
+// Slides layer[0] out and layer[1] in, for every line that changed, each
+// from its start on. The lines only move along x.
+static void transitionUpdate(Animation *animation, const uint32_t progress) {
+  TextLine *lines[] = { &line1, &line2, &line3 };
+
+  for (int l = 0; l < 3; l++) {
+    TextLine *line = lines[l];
+    if (!line->moving) continue;
+    uint32_t distance = 0;
+    if (progress > line->start) {
+      distance = easing_out((progress - line->start) * ANIMATION_NORMALIZED_MAX /
+                            (ANIMATION_NORMALIZED_MAX - line->start));
+    }
+    for (int i = 0; i < 2; i++) {
+      GRect frame = ui_get_frame(line->layer[i]);
+      int16_t x = interpolate(line->from_x[i], line->to_x[i], distance);
+      if (frame.origin.x == x) continue;
+      frame.origin.x = x;
+      ui_set_frame(line->layer[i], frame);
+    }
+  }
+}
+
+static void transitionStopped(Animation *animation, bool finished, void *context) {
+  TRACE_EVENT(TRACE_ANIM_STOP, finished);
+
+  // unscheduled to be restarted, or the window is going away
+  if (!finished) return;
+
+  TextLine *lines[] = { &line1, &line2, &line3 };
+  for (int l = 0; l < 3; l++) {
+    TextLine *line = lines[l];
+    if (!line->moving) continue;
+    line->moving = false;
+
+    // restore origin of the out layer, now showing the new text
+    GRect from_frame_out = ui_get_frame(line->layer[0]);
+    from_frame_out.origin.x = 0;
+    setLineText(line, 0, line->text);
+    ui_set_frame(line->layer[0], from_frame_out);
+
+    // and of the in layer, off screen again
+    GRect from_frame_in = ui_get_frame(line->layer[1]);
     if (from_frame_in.origin.y == line2_y) from_frame_in.origin.x = -144;
     else from_frame_in.origin.x = 144;
-    layer_set_frame(text_layer_get_layer(line->layer[1]), from_frame_in);
+    ui_set_frame(line->layer[1], from_frame_in);
+#if PHRASE_BITMAPS
+    // off screen until the next update, the out layer shows the phrase now
+    setLineText(line, 1, NULL);
+#endif
   }
 }
 
-void updateLayer(TextLine *animating_line, char* old_line, char* new_line) {
-//  if (animating_line->busy_animating_out || animating_line->busy_animating_in) return;
-
-  // --- test animate out
-  if (animation_is_scheduled((Animation*) animating_line->animate_out))
-	{
-	  animation_unschedule((Animation*) animating_line->animate_out);
-	}
-
-  // animate out current layer
-  GRect from_frame_out = layer_get_frame(text_layer_get_layer(animating_line->layer[0]));
-  GRect to_frame_out = animating_line->out_rect;
-
-  // Create the animation
-  animating_line->animate_out = property_animation_create_layer_frame(text_layer_get_layer(animating_line->layer[0]), &from_frame_out, &to_frame_out);
-  animation_set_duration((Animation*) animating_line->animate_out, ANIMATION_DURATION);
-  animation_set_curve((Animation*) animating_line->animate_out, AnimationCurveEaseOut);
-  animation_set_handlers((Animation*)(animating_line->animate_out), (AnimationHandlers) {
-    .stopped = (AnimationStoppedHandler)animateOutStoppedHandler
-  }, (void*)animating_line);
-
-  // --- test animate in
-  if (animation_is_scheduled((Animation*) animating_line->animate_in))
-	{
-	  animation_unschedule((Animation*) animating_line->animate_in);
-	}
-
-  // animate in current layer
-  GRect from_frame_in = layer_get_frame(text_layer_get_layer(animating_line->layer[1]));
-  GRect to_frame_in = layer_get_frame(text_layer_get_layer(animating_line->layer[0]));
-
-  // Create the animation
-  animating_line->animate_in = property_animation_create_layer_frame(text_layer_get_layer(animating_line->layer[1]), &from_frame_in, &to_frame_in);
-  animation_set_duration((Animation*) animating_line->animate_in, ANIMATION_DURATION);
-  animation_set_curve((Animation*) animating_line->animate_in, AnimationCurveEaseOut);
-  animation_set_handlers((Animation*) animating_line->animate_in, (AnimationHandlers) {
-    .stopped = (AnimationStoppedHandler)animateInStoppedHandler
-  }, (void*)animating_line);
-
-  GSize size= graphics_text_layout_get_content_size(new_line,
-                                        (animating_line->out_rect.origin.y==line1_y)?s_time_font_big:s_time_font,
-                                        GRect(0, 0, 200, animating_line->out_rect.size.h),
-                                        GTextOverflowModeTrailingEllipsis,
-                                        GTextAlignmentLeft);
-  APP_LOG(APP_LOG_LEVEL_DEBUG_VERBOSE , "line text size: %d", size.w);
-
-  // Schedule to occur ASAP with default settings
-  text_layer_set_text(animating_line->layer[0], old_line);
-  animation_schedule((Animation*) animating_line->animate_out);
-  animating_line->busy_animating_out = true;
-  // Schedule to occur ASAP with default settings
-  text_layer_set_text(animating_line->layer[1], new_line);
-  animation_schedule((Animation*) animating_line->animate_in);
-  animating_line->busy_animating_in = true;
+static const AnimationImplementation s_transition_implementation = {
+  .update = transitionUpdate,
+};
+
+// The transition is created once with the window and restarted on each
+// update, so that no heap is used on the tick path. It runs linearly, the
+// lines ease out through easing_out().
+static void createTransition(void) {
+  easing_init();
+  s_transition = animation_create();
+  animation_set_curve(s_transition, AnimationCurveLinear);
+  animation_set_implementation(s_transition, &s_transition_implementation);
+  animation_set_handlers(s_transition, (AnimationHandlers) {
+    .stopped = transitionStopped
+  }, NULL);
+}
+
+// Sets up the slide of a line to new_line, started by startTransition()
+void updateLayer(TextLine *animating_line, const char* new_line) {
+  const char* old_line = animating_line->text;
+  animating_line->text = new_line;
+
+  // instant swap, unless the line is still sliding from the last update
+  if (s_anim_mode == ANIM_POLICY_NONE && !animating_line->moving) {
+    setLineText(animating_line, 0, new_line);
+    return;
+  }
+
+  // animate out current layer, and in the other one in its place
+  animating_line->to_x[0] = animating_line->out_rect.origin.x;
+  animating_line->to_x[1] = 0;
+  animating_line->moving = true;
+
+  setLineText(animating_line, 0, old_line);
+  setLineText(animating_line, 1, new_line);
+}
+
+// Slides all the lines set up by updateLayer() together
+static void startTransition(void) {
+  TextLine *lines[] = { &line1, &line2, &line3 };
+  int moving = 0;
+
+  // lines still moving carry on from where they are, each moving line
+  // starting ANIM_STAGGER percent of the transition after the one above
+  animation_unschedule(s_transition);
+  for (int l = 0; l < 3; l++) {
+    if (lines[l]->moving) lines[l]->start = moving++ * ANIM_STAGGER * ANIMATION_NORMALIZED_MAX / 100;
+    for (int i = 0; i < 2; i++) {
+      lines[l]->from_x[i] = ui_get_frame(lines[l]->layer[i]).origin.x;
+    }
+  }
+  if (!moving) return;
+
+  if (s_anim_mode == ANIM_POLICY_NONE) {
+    transitionStopped(s_transition, true, NULL);
+    return;
+  }
+  animation_set_duration(s_transition, anim_policy_duration(s_anim_mode));
+  animation_schedule(s_transition);
+  TRACE_EVENT(TRACE_ANIM_START, s_anim_mode);
+}
+
+// Centers "time date" on the bottom bar, the time part being sized for its
+// widest value so only the date needs measuring, once a day.
+static void layoutBottomBar(const char* date) {
+  GFont font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+  int time_w = s_low_wake ? 0 : text_width("00:00 - ", font);
+  int x = (144 - time_w - text_width(date, font)) / 2;
+  if (x < 0) x = 0;
+
+  ui_set_frame(bottomtimelayer, GRect(x, 150, time_w, 18));
+  ui_set_frame(bottomdatelayer, GRect(x + time_w, 150, 144 - x - time_w, 18));
 }
 
 void update_watch(struct tm* t) {
   // Let's get the new text date
-  info_lines(t, new_time.topline, new_time.bottomline);
+  info_lines(t, new_time.bottomtime, new_time.bottomdate);
+
+  // Let's update the bottom bar, only the parts that changed get redrawn
+  if(strcmp(new_time.bottomdate, cur_time.bottomdate) != 0) {
+    layoutBottomBar(new_time.bottomdate);
+    ui_set_text(bottomdatelayer, new_time.bottomdate);
+  }
+  if(!s_low_wake && strcmp(new_time.bottomtime, cur_time.bottomtime) != 0) ui_set_text(bottomtimelayer, new_time.bottomtime);
 
-  // Let's update the bottom bar
-  text_layer_set_text(bottomlayer, new_time.bottomline);
+  // reset cur_time
+  strcpy(cur_time.bottomtime, new_time.bottomtime);
+  strcpy(cur_time.bottomdate, new_time.bottomdate);
 
-  // Let's get the new text time
-  fuzzy_time(t, new_time.line1, new_time.line2, new_time.line3);
+  // Let's get the new text time, nothing to do until the fuzzy time changes
+  int changed = fuzzy_clock_update(&fuzzy_clock, t);
+  if (!changed) return;
 
   // update hour only if changed
-  if(strcmp(new_time.line1, cur_time.line1) != 0) updateLayer(&line1, cur_time.line1, new_time.line1);
+  if(changed & FUZZY_LINE1) updateLayer(&line1, fuzzy_clock.line[0]);
   // update min1 only if changed
-  if(strcmp(new_time.line2, cur_time.line2) != 0) updateLayer(&line2, cur_time.line2, new_time.line2);
+  if(changed & FUZZY_LINE2) updateLayer(&line2, fuzzy_clock.line[1]);
   // update min2 only if changed happens on
-  if(strcmp(new_time.line3, cur_time.line3) != 0) updateLayer(&line3, cur_time.line3, new_time.line3);
+  if(changed & FUZZY_LINE3) updateLayer(&line3, fuzzy_clock.line[2]);
+  startTransition();
 
-  // reset cur_time
-  cur_time = new_time;
-  
   // vibrate at o'clock from 8 to 24
 //  if(t->tm_min == 0 && t->tm_sec == 0 && t->tm_hour >= 8 && t->tm_hour <= 24 ) vibes_double_pulse();
 //  if(t->tm_min == 59 && t->tm_sec == 57 && t->tm_hour >= 7 && t->tm_hour <= 23 ) vibes_short_pulse();
@@ -166,178 +366,243 @@ void update_watch(struct tm* t) {
 static void battery_handler(BatteryChargeState charge_state) {
   static char s_battery_buffer[10];
 
+  s_anim_mode = anim_policy_select(s_anim_setting, charge_state);
+
   if (charge_state.is_charging) {
-    layer_set_hidden ((Layer *)s_ch_bitmap_layer, false);
-//    bitmap_layer_set_bitmap(s_ch_bitmap_layer, s_bitmap_charging);
+    ui_set_hidden(s_ch_bitmap_layer, false);
+    // decoded the first time it is needed
+    ui_set_bitmap(s_ch_bitmap_layer, status_icon(STATUS_ICON_CHARGING));
   } 
   else {
-    layer_set_hidden ((Layer *)s_ch_bitmap_layer, true);
+    ui_set_hidden(s_ch_bitmap_layer, true);
   }
-  snprintf(s_battery_buffer, sizeof(s_battery_buffer), "%d%%", charge_state.charge_percent);
-  text_layer_set_text(batterylayer, s_battery_buffer);
-
-  GSize size= graphics_text_layout_get_content_size(s_battery_buffer,
-                                        fonts_get_system_font(FONT_KEY_GOTHIC_14),
-                                        GRect(0, 0, 100, 18),
-                                        GTextOverflowModeTrailingEllipsis,
-                                        GTextAlignmentRight);
-  APP_LOG(APP_LOG_LEVEL_DEBUG_VERBOSE , "battery text size: %d", size.w);
+  mini_format(s_battery_buffer, sizeof(s_battery_buffer), "%d%%", charge_state.charge_percent);
+  ui_set_text(batterylayer, s_battery_buffer);
+
+  // charging icon right after the text
+  int16_t width = text_width(s_battery_buffer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+  ui_set_frame(s_ch_bitmap_layer, GRect(width + 2, 0, 20, 18));
 }
 
 static void bt_handler(bool connected) {
 
+  // icons are decoded the first time they are needed
   if (connected) {
-    bitmap_layer_set_bitmap(s_bt_bitmap_layer, s_bitmap_bt_on);
+    ui_set_bitmap(s_bt_bitmap_layer, status_icon(STATUS_ICON_BT_ON));
   } else {
-    bitmap_layer_set_bitmap(s_bt_bitmap_layer, s_bitmap_bt_off);
-    vibes_short_pulse();
+    ui_set_bitmap(s_bt_bitmap_layer, status_icon(STATUS_ICON_BT_OFF));
+    // once per disconnection, not again when relaunched
+    if (s_connected) vibes_short_pulse();
   }
+  s_connected = connected;
 }
 
-static void main_window_load(Window *window) {
-  // Load GFont
+// Changes coalesced by status_events, at most once per event loop turn
+static void status_handler(const StatusState *state, int changed) {
+  if (changed & STATUS_BATTERY) battery_handler(state->battery);
+  if (changed & STATUS_BLUETOOTH) bt_handler(state->connected);
+}
+
+// Second startup stage, once the first frame is drawn: the custom fonts
+// replace the system one, and the Bluetooth state is shown.
+static void startup_timer_handler(void *data) {
+  s_startup_timer = NULL;
+
+#if !PHRASE_BITMAPS
   s_time_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_DOMESTIC_BOLD_SUBSET_36));
   s_time_font_big = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_DOMESTIC_BOLD_SUBSET_48));
+  s_custom_fonts = true;
+
+  TextLine *lines[] = { &line1, &line2, &line3 };
+  for (int l = 0; l < 3; l++) {
+    for (int i = 0; i < 2; i++) {
+      ui_set_font(lines[l]->layer[i], s_time_font);
+      // picks the big font for line1 when the text fits
+      if (l == 0) setLineText(lines[l], i, ui_get_text(lines[l]->layer[i]));
+    }
+  }
+#endif
+
+  bt_handler(bluetooth_connection_service_peek());
+}
+
+static void main_window_load(Window *window) {
+#if !PHRASE_BITMAPS
+  // The time is first drawn with a system font, the custom fonts are loaded
+  // once it is on screen (startup_timer_handler)
+  s_time_font = s_time_font_big = fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD);
+#endif
   
   // Init the text layers used to show the time
 
   // line1
-  line1.layer[0] = text_layer_create(GRect(0, line1_y, 144, 60));
-  text_layer_set_background_color(line1.layer[0], GColorClear);
-//  text_layer_set_font(line1.layer[0], fonts_get_system_font(FONT_KEY_BITHAM_42_BOLD));
-  text_layer_set_font(line1.layer[0], s_time_font_big);
-  text_layer_set_text_alignment(line1.layer[0], GTextAlignmentLeft);
-//  text_layer_set_overflow_mode (line1.layer[0], GTextOverflowModeWordWrap);
-
-  line1.layer[1] = text_layer_create(GRect(144, line1_y, 144, 60));
-  text_layer_set_background_color(line1.layer[1], GColorClear);
-  text_layer_set_font(line1.layer[1], s_time_font_big);
-  text_layer_set_text_alignment(line1.layer[1], GTextAlignmentLeft);
-//  text_layer_set_overflow_mode (line1.layer[1], GTextOverflowModeWordWrap);
-
+  line1.layer[0] = createLineLayer(GRect(0, line1_y, 144, 60), s_time_font_big);
+  line1.layer[1] = createLineLayer(GRect(144, line1_y, 144, 60), s_time_font_big);
   line1.out_rect = GRect(-144, line1_y, 144, 60);
-  line1.busy_animating_out = false;
-  line1.busy_animating_in = false;
+  line1.moving = false;
+  line1.text = "";
   
   // line2
-  line2.layer[0] = text_layer_create(GRect(0, line2_y, 144, 50));
-  text_layer_set_background_color(line2.layer[0], GColorClear);
-  text_layer_set_font(line2.layer[0], s_time_font);
-  text_layer_set_text_alignment(line2.layer[0], GTextAlignmentLeft);
-//  text_layer_set_overflow_mode (line2.layer[0], GTextOverflowModeWordWrap);
-
-  line2.layer[1] = text_layer_create(GRect(-144, line2_y, 144, 50));
-  text_layer_set_background_color(line2.layer[1], GColorClear);
-  text_layer_set_font(line2.layer[1], s_time_font);
-  text_layer_set_text_alignment(line2.layer[1], GTextAlignmentLeft);
-//  text_layer_set_overflow_mode (line2.layer[1], GTextOverflowModeWordWrap);
-
+  line2.layer[0] = createLineLayer(GRect(0, line2_y, 144, 50), s_time_font);
+  line2.layer[1] = createLineLayer(GRect(-144, line2_y, 144, 50), s_time_font);
   line2.out_rect = GRect(144, line2_y, 144, 50);
-  line2.busy_animating_out = false;
-  line2.busy_animating_in = false;
+  line2.moving = false;
+  line2.text = "";
 
   // line3
-  line3.layer[0] = text_layer_create(GRect(0, line3_y, 144, 50));
-  text_layer_set_background_color(line3.layer[0], GColorClear);
-  text_layer_set_font(line3.layer[0], s_time_font);
-  text_layer_set_text_alignment(line3.layer[0], GTextAlignmentLeft);
-//  text_layer_set_overflow_mode (line3.layer[0], GTextOverflowModeWordWrap);
-
-  line3.layer[1] = text_layer_create(GRect(144, line3_y, 144, 50));
-  text_layer_set_background_color(line3.layer[1], GColorClear);
-  text_layer_set_font(line3.layer[1], s_time_font);
-  text_layer_set_text_alignment(line3.layer[1], GTextAlignmentLeft);
-//  text_layer_set_overflow_mode (line3.layer[1], GTextOverflowModeWordWrap);
-
+  line3.layer[0] = createLineLayer(GRect(0, line3_y, 144, 50), s_time_font);
+  line3.layer[1] = createLineLayer(GRect(144, line3_y, 144, 50), s_time_font);
   line3.out_rect = GRect(-144, line3_y, 144, 50);
-  line3.busy_animating_out = false;
-  line3.busy_animating_in = false;
+  line3.moving = false;
+  line3.text = "";
+
+  createTransition();
 
   // battery text
-  batterylayer = text_layer_create(GRect(0, 0, 30, 18));
-  text_layer_set_background_color(batterylayer, GColorClear);
-  text_layer_set_font(batterylayer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-  text_layer_set_text_alignment(batterylayer, GTextAlignmentRight);
-
-  // Create charging GBitmap, then set to created BitmapLayer
-  s_bitmap_charging = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_CHARGING);
-  s_ch_bitmap_layer = bitmap_layer_create(GRect(32, 0, 20, 18));
-  bitmap_layer_set_alignment(s_ch_bitmap_layer, GAlignLeft);
-  layer_set_hidden ((Layer *)s_ch_bitmap_layer, true);
-  bitmap_layer_set_bitmap(s_ch_bitmap_layer, s_bitmap_charging);
+  batterylayer = createText(GRect(0, 0, 30, 18), fonts_get_system_font(FONT_KEY_GOTHIC_14));
+
+  // charging bitmap, its icon is set when first charging
+  s_ch_bitmap_layer = createBitmap(GRect(32, 0, 20, 18), GAlignLeft, GCompOpAssign);
+  ui_set_hidden(s_ch_bitmap_layer, true);
   
-  // bottom text
-  bottomlayer = text_layer_create(GRect(0, 150, 144, 18));
-//  text_layer_set_text_color(bottomlayer], GColorWhite);
-  text_layer_set_background_color(bottomlayer, GColorClear);
-  text_layer_set_font(bottomlayer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-  text_layer_set_text_alignment(bottomlayer, GTextAlignmentCenter);
-
-  // Create GBitmap, then set to created BitmapLayer
-  s_bitmap_bt_on = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BLUETOOTH_ON);
-  s_bitmap_bt_off = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BLUETOOTH_OFF);
-  s_bt_bitmap_layer = bitmap_layer_create(GRect(100, 0, 40, 22));
-//  bitmap_layer_set_background_color(s_bt_bitmap_layer, GColorWhite);
-//  bitmap_layer_set_compositing_mode(s_bt_bitmap_layer, GCompOpAssign);
-  bitmap_layer_set_alignment(s_bt_bitmap_layer, GAlignRight);
+  // bottom text, time and date parts (laid out by layoutBottomBar)
+  bottomtimelayer = createText(GRect(0, 150, 72, 18), fonts_get_system_font(FONT_KEY_GOTHIC_14));
+  ui_set_hidden(bottomtimelayer, s_low_wake);
+
+  bottomdatelayer = createText(GRect(72, 150, 72, 18), fonts_get_system_font(FONT_KEY_GOTHIC_14));
+
+  // Bluetooth bitmap, its icon is set by bt_handler
+  s_bt_bitmap_layer = createBitmap(GRect(100, 0, 40, 22), GAlignRight, GCompOpAssign);
     
+  // Nothing is shown yet
+  memset(&cur_time, 0, sizeof(cur_time));
+  if (!fuzzy_locale_load(s_locale)) {
+    TRACE_ERROR("cannot load locale %d", s_locale);
+    fuzzy_locale_load(LOCALE_DEFAULT);
+  }
+  fuzzy_clock_init(&fuzzy_clock);
+
   // Ensures time is displayed immediately (will break if NULL tick event accessed).
   // (This is why it's a good idea to have a separate routine to do the update itself.)
   time_t now = time(NULL);
   struct tm *t = localtime(&now);
+
+  // Relaunched within the same fuzzy time: the lines are swapped in, the
+  // transition mode is picked again by battery_handler() below
+  int size = persist_read_data(PERSIST_KEY_DISPLAY, &s_display_state, sizeof(s_display_state));
+  bool restored = size == sizeof(s_display_state) && s_display_state.version == DISPLAY_STATE_VERSION;
+  if (!restored) memset(&s_display_state, 0, sizeof(s_display_state));
+  s_connected = restored ? s_display_state.flags & DISPLAY_CONNECTED : true;
+  if (restored && s_display_state.locale == s_locale && s_display_state.fuzzy_key == fuzzy_time_key(t)) {
+    s_anim_mode = ANIM_POLICY_NONE;
+  }
   update_watch(t);
   
   battery_handler(battery_state_service_peek());
-  
-  bt_handler(bluetooth_connection_service_peek());
+
+  // the rest waits for the next turn of the event loop
+  s_startup_timer = app_timer_register(0, startup_timer_handler, NULL);
 
   Layer *root_layer = window_get_root_layer(window);
+#if CANVAS_LAYER
+  canvas_create(root_layer);
+#endif
 	
-  layer_add_child(root_layer, text_layer_get_layer(line3.layer[0]));
-  layer_add_child(root_layer, text_layer_get_layer(line3.layer[1]));
-  layer_add_child(root_layer, text_layer_get_layer(line2.layer[0]));
-  layer_add_child(root_layer, text_layer_get_layer(line2.layer[1]));
-  layer_add_child(root_layer, text_layer_get_layer(line1.layer[0]));
-  layer_add_child(root_layer, text_layer_get_layer(line1.layer[1]));
-  layer_add_child(root_layer, text_layer_get_layer(batterylayer));
-  layer_add_child(root_layer, text_layer_get_layer(bottomlayer));
-  layer_add_child(root_layer, bitmap_layer_get_layer(s_bt_bitmap_layer));
-  layer_add_child(root_layer, bitmap_layer_get_layer(s_ch_bitmap_layer));
+  ui_add(root_layer, line3.layer[0]);
+  ui_add(root_layer, line3.layer[1]);
+  ui_add(root_layer, line2.layer[0]);
+  ui_add(root_layer, line2.layer[1]);
+  ui_add(root_layer, line1.layer[0]);
+  ui_add(root_layer, line1.layer[1]);
+  ui_add(root_layer, batterylayer);
+  ui_add(root_layer, bottomtimelayer);
+  ui_add(root_layer, bottomdatelayer);
+  ui_add(root_layer, s_bt_bitmap_layer);
+  ui_add(root_layer, s_ch_bitmap_layer);
 }
 
 static void main_window_unload(Window *window) {
+  // Startup may not be over yet
+  if (s_startup_timer) app_timer_cancel(s_startup_timer);
+  s_startup_timer = NULL;
+
+  // Saved for the next launch, unless it is what that launch read
+  DisplayState state = {
+    .version = DISPLAY_STATE_VERSION,
+    .locale = s_locale,
+    .flags = s_connected ? DISPLAY_CONNECTED : 0,
+    .fuzzy_key = fuzzy_clock.key,
+  };
+  if (memcmp(&state, &s_display_state, sizeof(state)) != 0) {
+    persist_write_data(PERSIST_KEY_DISPLAY, &state, sizeof(state));
+  }
+
+  // Stop and free the line animation
+  animation_destroy(s_transition);
+
   // Destroy TextLayers
-  text_layer_destroy(line1.layer[0]);
-  text_layer_destroy(line1.layer[1]);
-  text_layer_destroy(line2.layer[0]);
-  text_layer_destroy(line2.layer[1]);
-  text_layer_destroy(line3.layer[0]);
-  text_layer_destroy(line3.layer[1]);
-  text_layer_destroy(batterylayer);
-  text_layer_destroy(bottomlayer);
+  destroyLineLayers(&line1);
+  destroyLineLayers(&line2);
+  destroyLineLayers(&line3);
+  destroyText(batterylayer);
+  destroyText(bottomtimelayer);
+  destroyText(bottomdatelayer);
 
   // Destroy BitmapLayer
-  bitmap_layer_destroy(s_bt_bitmap_layer);
-  bitmap_layer_destroy(s_ch_bitmap_layer);
+  destroyBitmap(s_bt_bitmap_layer);
+  destroyBitmap(s_ch_bitmap_layer);
+#if CANVAS_LAYER
+  canvas_destroy();
+#endif
   
   // Destroy GBitmap
-  gbitmap_destroy(s_bitmap_bt_on);
-  gbitmap_destroy(s_bitmap_bt_off);
-  gbitmap_destroy(s_bitmap_charging);
+  status_icons_unload();
 
+#if !PHRASE_BITMAPS
   // Unload GFont
-  fonts_unload_custom_font(s_time_font);
-  fonts_unload_custom_font(s_time_font_big);
+  if (s_custom_fonts) {
+    fonts_unload_custom_font(s_time_font);
+    fonts_unload_custom_font(s_time_font_big);
+    s_custom_fonts = false;
+  }
+#endif
+  text_metrics_reset();
+  fuzzy_locale_unload();
   
   // Stop any animation in progress
   animation_unschedule_all();  
 }
 
 static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  TRACE_EVENT(TRACE_TICK, tick_time->tm_min);
   update_watch(tick_time);
 }
+
+static void bucket_timer_handler(void *data);
+
+// Low-wake mode: sleep until the next fuzzy time change instead of ticking
+// every minute.
+static void schedule_bucket_timer(struct tm *t) {
+  uint32_t timeout_s = fuzzy_time_minutes_to_change(t) * 60 - t->tm_sec;
+  s_bucket_timer = app_timer_register(timeout_s * 1000, bucket_timer_handler, NULL);
+}
+
+static void bucket_timer_handler(void *data) {
+  s_bucket_timer = NULL;
+  time_t now = time(NULL);
+  struct tm *t = localtime(&now);
+  TRACE_EVENT(TRACE_TICK, t->tm_min);
+  update_watch(t);
+  schedule_bucket_timer(t);
+}
   
 static void init() {
+  s_low_wake = persist_exists(PERSIST_KEY_LOW_WAKE) ? persist_read_bool(PERSIST_KEY_LOW_WAKE) : LOW_WAKE_DEFAULT;
+  s_locale = persist_exists(PERSIST_KEY_LOCALE) ? persist_read_int(PERSIST_KEY_LOCALE) : LOCALE_DEFAULT;
+  s_anim_setting = persist_exists(PERSIST_KEY_ANIM_POLICY) ? persist_read_int(PERSIST_KEY_ANIM_POLICY) : ANIM_POLICY_DEFAULT;
+  s_anim_mode = anim_policy_select(s_anim_setting, battery_state_service_peek());
+
+
   // Create main Window element and assign to pointer
   s_main_window = window_create();
 //  window_set_background_color(s_main_window, GColorBlack);
@@ -351,15 +616,23 @@ static void init() {
   // Show the Window on the watch, with animated=true
   window_stack_push(s_main_window, true);
   
-  // Register with TickTimerService
-  tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
-  // Register with BatteryService
-  battery_state_service_subscribe(battery_handler);
-  // Register BluetoothService
-  bluetooth_connection_service_subscribe(bt_handler);
+  // Register with TickTimerService, or wake up on fuzzy time changes only
+  if (s_low_wake) {
+    time_t now = time(NULL);
+    schedule_bucket_timer(localtime(&now));
+  }
+  else {
+    tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
+  }
+  // Register with BatteryService and BluetoothService, through status_events
+  status_events_subscribe(status_handler);
 }
 
 static void deinit() {
+  if (s_bucket_timer) app_timer_cancel(s_bucket_timer);
+  status_events_unsubscribe();
+  trace_dump();
+
   // Destroy Window
   window_destroy(s_main_window);
 }
@@ -368,4 +641,5 @@ int main(void) {
   init();
   app_event_loop();
   deinit();
+  return 0;
 }
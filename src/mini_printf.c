@@ -22,26 +22,24 @@ static unsigned int
 mini_strlen(const char *s)
 {
 	unsigned int len = 0;
-	while (s[len++]) /* do nothing */;
+	while (s[len]) len++;
 	return len;
 }
 
+/* value is the magnitude, the sign counts in the zero_pad width */
 static unsigned int
-mini_itoa(int value, unsigned int radix, unsigned int uppercase,
-	 char *buffer, unsigned int zero_pad)
+mini_itoa(unsigned int value, unsigned int radix, unsigned int uppercase,
+	 unsigned int negative, char *buffer, unsigned int zero_pad)
 {
 	char	*pbuffer = buffer;
-	int	negative = 0;
 	unsigned int	i, len;
 
 	/* No support for unusual radixes. */
 	if (radix > 16)
 		return 0;
 
-	if (value < 0) {
-		negative = 1;
-		value = -value;
-	}
+	if (negative && zero_pad)
+		zero_pad--;
 
 	/* This builds the string back to front ... */
 	do {
@@ -70,92 +68,115 @@ mini_itoa(int value, unsigned int radix, unsigned int uppercase,
 	return len;
 }
 
-int
-mini_vsnprintf(char *buffer, unsigned int buffer_len, char *fmt, va_list va)
+struct mini_buff {
+	char *buffer, *pbuffer;
+	unsigned int buffer_len;
+};
+
+static int
+mini_putc(char ch, struct mini_buff *b)
 {
-	char *pbuffer = buffer;
-	char bf[24];
-	char ch;
+	if ((unsigned int)((b->pbuffer - b->buffer) + 1) >= b->buffer_len)
+		return 0;
+	*(b->pbuffer++) = ch;
+	*(b->pbuffer) = '\0';
+	return 1;
+}
 
-	int _putc(char ch)
-	{
-		if ((unsigned int)((pbuffer - buffer) + 1) >= buffer_len)
-			return 0;
-		*(pbuffer++) = ch;
-		*(pbuffer) = '\0';
-		return 1;
-	}
+static int
+mini_puts(char *s, unsigned int len, struct mini_buff *b)
+{
+	unsigned int i;
 
-	int _puts(char *s, unsigned int len)
-	{
-		unsigned int i;
+	if (b->buffer_len - (b->pbuffer - b->buffer) - 1 < len)
+		len = b->buffer_len - (b->pbuffer - b->buffer) - 1;
 
-		if (buffer_len - (pbuffer - buffer) - 1 < len)
-			len = buffer_len - (pbuffer - buffer) - 1;
+	/* Copy to buffer */
+	for (i = 0; i < len; i++)
+		*(b->pbuffer++) = s[i];
+	*(b->pbuffer) = '\0';
 
-		/* Copy to buffer */
-		for (i = 0; i < len; i++)
-			*(pbuffer++) = s[i];
-		*(pbuffer) = '\0';
+	return len;
+}
 
-		return len;
-	}
+int
+mini_vsnprintf(char *buffer, unsigned int buffer_len, char *fmt, va_list va)
+{
+	struct mini_buff b;
+	char bf[24];
+	char ch;
+
+	b.buffer = buffer;
+	b.pbuffer = buffer;
+	b.buffer_len = buffer_len;
+	if (buffer_len)
+		*buffer = '\0';
 
 	while ((ch=*(fmt++))) {
-		if ((unsigned int)((pbuffer - buffer) + 1) >= buffer_len)
+		if ((unsigned int)((b.pbuffer - b.buffer) + 1) >= buffer_len)
 			break;
 		if (ch!='%')
-			_putc(ch);
+			mini_putc(ch, &b);
 		else {
-			char zero_pad = 0;
+			unsigned int zero_pad = 0;
 			char *ptr;
 			unsigned int len;
+			int value;
 
 			ch=*(fmt++);
 
 			/* Zero padding requested */
 			if (ch=='0') {
 				ch=*(fmt++);
-				if (ch == '\0')
-					goto end;
-				if (ch >= '0' && ch <= '9')
-					zero_pad = ch - '0';
-				ch=*(fmt++);
+				while (ch >= '0' && ch <= '9') {
+					zero_pad = zero_pad * 10 + (ch - '0');
+					ch=*(fmt++);
+				}
+				/* bf holds 22 digits, the sign and the NUL */
+				if (zero_pad > sizeof(bf) - 2)
+					zero_pad = sizeof(bf) - 2;
 			}
 
 			switch (ch) {
 				case 0:
 					goto end;
 
-				case 'u':
 				case 'd':
-					len = mini_itoa(va_arg(va, unsigned int), 10, 0, bf, zero_pad);
-					_puts(bf, len);
+					value = va_arg(va, int);
+					/* negated as unsigned, INT_MIN has no positive int */
+					len = mini_itoa(value < 0 ? -(unsigned int)value : (unsigned int)value,
+							10, 0, value < 0, bf, zero_pad);
+					mini_puts(bf, len, &b);
+					break;
+
+				case 'u':
+					len = mini_itoa(va_arg(va, unsigned int), 10, 0, 0, bf, zero_pad);
+					mini_puts(bf, len, &b);
 					break;
 
 				case 'x':
 				case 'X':
-					len = mini_itoa(va_arg(va, unsigned int), 16, (ch=='X'), bf, zero_pad);
-					_puts(bf, len);
+					len = mini_itoa(va_arg(va, unsigned int), 16, (ch=='X'), 0, bf, zero_pad);
+					mini_puts(bf, len, &b);
 					break;
 
 				case 'c' :
-					_putc((char)(va_arg(va, int)));
+					mini_putc((char)(va_arg(va, int)), &b);
 					break;
 
 				case 's' :
 					ptr = va_arg(va, char*);
-					_puts(ptr, mini_strlen(ptr));
+					mini_puts(ptr, mini_strlen(ptr), &b);
 					break;
 
 				default:
-					_putc(ch);
+					mini_putc(ch, &b);
 					break;
 			}
 		}
 	}
 end:
-	return pbuffer - buffer;
+	return b.pbuffer - b.buffer;
 }
 
 
@@ -170,3 +191,70 @@ mini_snprintf(char* buffer, unsigned int buffer_len, char *fmt, ...)
 
 	return ret;
 }
+
+
+/*
+ * Single conversion fast paths, used by the mini_format() front-end when
+ * the format is a literal it knows. They write a NUL terminated string
+ * and return its length, truncated to buffer_len - 1 characters.
+ */
+
+unsigned int
+fmt_str(char *buffer, unsigned int buffer_len, const char *s)
+{
+	unsigned int len = 0;
+
+	if (!buffer_len)
+		return 0;
+	while (s[len] && len + 1 < buffer_len) {
+		buffer[len] = s[len];
+		len++;
+	}
+	buffer[len] = '\0';
+	return len;
+}
+
+unsigned int
+fmt_u32(char *buffer, unsigned int buffer_len, uint32_t value)
+{
+	char bf[10];
+	unsigned int n = 0, len = 0;
+
+	if (!buffer_len)
+		return 0;
+
+	do {
+		bf[n++] = '0' + value % 10;
+		value /= 10;
+	} while (value);
+
+	while (n && len + 1 < buffer_len)
+		buffer[len++] = bf[--n];
+	buffer[len] = '\0';
+	return len;
+}
+
+unsigned int
+fmt_i32(char *buffer, unsigned int buffer_len, int32_t value)
+{
+	if (value >= 0)
+		return fmt_u32(buffer, buffer_len, value);
+	if (buffer_len < 2)
+		return fmt_str(buffer, buffer_len, "");
+
+	buffer[0] = '-';
+	/* negate as unsigned, INT32_MIN has no positive int32_t */
+	return 1 + fmt_u32(buffer + 1, buffer_len - 1, -(uint32_t)value);
+}
+
+unsigned int
+fmt_i32_percent(char *buffer, unsigned int buffer_len, int32_t value)
+{
+	unsigned int len = fmt_i32(buffer, buffer_len, value);
+
+	if (len + 1 < buffer_len) {
+		buffer[len++] = '%';
+		buffer[len] = '\0';
+	}
+	return len;
+}
@@ -10,8 +10,30 @@
 #define __MINI_PRINTF__
 
 #include <stdarg.h>
+#include <stdint.h>
 
 int mini_vsnprintf(char* buffer, unsigned int buffer_len, char *fmt, va_list va);
 int mini_snprintf(char* buffer, unsigned int buffer_len, char *fmt, ...);
 
+unsigned int fmt_str(char* buffer, unsigned int buffer_len, const char *s);
+unsigned int fmt_u32(char* buffer, unsigned int buffer_len, uint32_t value);
+unsigned int fmt_i32(char* buffer, unsigned int buffer_len, int32_t value);
+unsigned int fmt_i32_percent(char* buffer, unsigned int buffer_len, int32_t value);
+
+/*
+ * mini_format(buffer, buffer_len, fmt, arg) formats a single argument.
+ * When fmt is one of the literals below, the choice is made at compile
+ * time and goes straight to the matching fmt_*() function; any other
+ * format falls back to mini_snprintf().
+ */
+#define MINI_FMT_IS(fmt, literal) \
+	(__builtin_constant_p(fmt) && !__builtin_strcmp((fmt), (literal)))
+
+#define mini_format(buffer, buffer_len, fmt, arg) \
+	(MINI_FMT_IS(fmt, "%s") ? (int)fmt_str((buffer), (buffer_len), (const char *)(uintptr_t)(arg)) : \
+	 MINI_FMT_IS(fmt, "%u") ? (int)fmt_u32((buffer), (buffer_len), (uint32_t)(uintptr_t)(arg)) : \
+	 MINI_FMT_IS(fmt, "%d") ? (int)fmt_i32((buffer), (buffer_len), (int32_t)(intptr_t)(arg)) : \
+	 MINI_FMT_IS(fmt, "%d%%") ? (int)fmt_i32_percent((buffer), (buffer_len), (int32_t)(intptr_t)(arg)) : \
+	 mini_snprintf((buffer), (buffer_len), (fmt), (arg)))
+
 #endif
@@ -0,0 +1,73 @@
+#include "phrase_bitmaps.h"
+#include "french_time.h"
+#include "settings.h"
+
+#if PHRASE_BITMAPS
+
+// Two bitmaps for each of the three lines
+#define PHRASE_SLOTS 6
+
+typedef struct {
+  int entry;
+  int refs;
+  uint8_t* data;
+  GBitmap* bitmap;
+} PhraseSlot;
+
+static PhraseSlot s_slots[PHRASE_SLOTS];
+
+// Resource index entry of a phrase: offset and size of its .pbi data
+static bool load_entry(ResHandle h, int entry, uint32_t* offset, uint32_t* size) {
+  uint8_t e[8];
+  if (resource_load_byte_range(h, 4 + entry * 8, e, sizeof(e)) != sizeof(e)) return false;
+  *offset = e[0] | e[1] << 8 | e[2] << 16 | (uint32_t)e[3] << 24;
+  *size = e[4] | e[5] << 8 | e[6] << 16 | (uint32_t)e[7] << 24;
+  return *size != 0;
+}
+
+GBitmap* phrase_bitmap_acquire(const char* phrase, bool big) {
+  int index = fuzzy_phrase_index(phrase);
+  if (index <= 0) return NULL;
+  int entry = index * 2 + big;
+
+  PhraseSlot* free_slot = NULL;
+  for (int i = 0; i < PHRASE_SLOTS; i++) {
+    if (s_slots[i].refs && s_slots[i].entry == entry) {
+      s_slots[i].refs++;
+      return s_slots[i].bitmap;
+    }
+    if (!s_slots[i].refs && !free_slot) free_slot = &s_slots[i];
+  }
+  if (!free_slot) return NULL;
+
+  ResHandle h = resource_get_handle(RESOURCE_ID_PHRASE_BITMAPS);
+  uint32_t offset, size;
+  if (!load_entry(h, entry, &offset, &size)) return NULL;
+
+  uint8_t* data = malloc(size);
+  if (!data) return NULL;
+  if (resource_load_byte_range(h, offset, data, size) != size) {
+    free(data);
+    return NULL;
+  }
+  free_slot->entry = entry;
+  free_slot->refs = 1;
+  free_slot->data = data;
+  free_slot->bitmap = gbitmap_create_with_data(data);
+  return free_slot->bitmap;
+}
+
+void phrase_bitmap_release(GBitmap* bitmap) {
+  if (!bitmap) return;
+  for (int i = 0; i < PHRASE_SLOTS; i++) {
+    PhraseSlot* slot = &s_slots[i];
+    if (slot->refs && slot->bitmap == bitmap && --slot->refs == 0) {
+      gbitmap_destroy(slot->bitmap);
+      free(slot->data);
+      slot->bitmap = NULL;
+      slot->data = NULL;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "pebble.h"
+
+/*
+ * Fuzzy time phrases pre-rendered by host/render_phrases.c at build time
+ * (PHRASE_BITMAPS resource), for the PHRASE_BITMAPS mode. A phrase bitmap
+ * is read from the resource when first shown and shared while in use, so
+ * a steady face holds one bitmap per line, two while a line slides.
+ */
+
+// Bitmap of a phrase returned by the fuzzy_clock, NULL for "" and other strings
+GBitmap* phrase_bitmap_acquire(const char* phrase, bool big);
+
+// Drops a bitmap from phrase_bitmap_acquire(), NULL is ignored
+void phrase_bitmap_release(GBitmap* bitmap);
@@ -0,0 +1,55 @@
+#pragma once
+
+// Keys of the values kept in persistent storage
+#define PERSIST_KEY_LOW_WAKE 1
+#define PERSIST_KEY_LOCALE 2
+#define PERSIST_KEY_ANIM_POLICY 3
+#define PERSIST_KEY_DISPLAY 4       // what was shown on exit (main.c)
+
+// Low-wake mode: wake up only when the fuzzy time changes (every 5 minutes)
+// instead of every minute. The precise time of the bottom bar is not shown.
+#define LOW_WAKE_DEFAULT false
+
+// Language of the fuzzy time and the date, a FuzzyLocaleId (french_time.h)
+#define LOCALE_DEFAULT LOCALE_FR
+
+// Line transitions (anim_policy.h): in the automatic setting, the full
+// slide while charging or from ANIM_FULL_MIN_PERCENT of battery, a shorter
+// one from ANIM_REDUCED_MIN_PERCENT, an instant swap below.
+#define ANIM_POLICY_DEFAULT ANIM_POLICY_AUTO
+#define ANIM_FULL_MIN_PERCENT 50
+#define ANIM_REDUCED_MIN_PERCENT 30
+#define ANIM_FULL_DURATION 800
+#define ANIM_REDUCED_DURATION 300
+// Each sliding line starts that percent of the transition after the one
+// above it (below 50), all at once with 0
+#ifndef ANIM_STAGGER
+#define ANIM_STAGGER 0
+#endif
+
+// A Bluetooth disconnection is only shown, and vibrated, once it lasted
+// that long (ms): a connection flapping faster than this goes unnoticed
+#define BT_DEBOUNCE_MS 10000
+
+// Tracing (trace.h): logs up to TRACE_LEVEL are compiled in, none by
+// default, and with TRACE_EVENTS above 0 the last TRACE_EVENTS tick,
+// transition, battery and Bluetooth events are kept in RAM, 8 bytes each,
+// and logged when the app exits.
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 0
+#endif
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS 0
+#endif
+
+// Phrase bitmaps mode: the fuzzy time lines are pre-rendered at build time
+// (PHRASE_BITMAPS resource) and drawn as bitmaps instead of text.
+#ifndef PHRASE_BITMAPS
+#define PHRASE_BITMAPS 0
+#endif
+
+// Canvas mode: one layer draws all the texts and icons (canvas.h) instead
+// of a layer each.
+#ifndef CANVAS_LAYER
+#define CANVAS_LAYER 0
+#endif
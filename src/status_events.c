@@ -0,0 +1,72 @@
+#include "status_events.h"
+#include "settings.h"
+#include "trace.h"
+
+static StatusHandler s_handler;
+static StatusState s_shown;     // as last handed to s_handler
+static StatusState s_latest;    // as last reported by the services
+static AppTimer* s_flush_timer;
+static AppTimer* s_bt_timer;    // running while a disconnection is debounced
+
+static bool battery_equal(BatteryChargeState a, BatteryChargeState b) {
+  return a.charge_percent == b.charge_percent && a.is_charging == b.is_charging && a.is_plugged == b.is_plugged;
+}
+
+static void flush(void* data) {
+  s_flush_timer = NULL;
+
+  int changed = 0;
+  if (!battery_equal(s_latest.battery, s_shown.battery)) changed |= STATUS_BATTERY;
+  if (!s_bt_timer && s_latest.connected != s_shown.connected) changed |= STATUS_BLUETOOTH;
+  if (!changed) return;
+
+  s_shown.battery = s_latest.battery;
+  if (changed & STATUS_BLUETOOTH) s_shown.connected = s_latest.connected;
+  s_handler(&s_shown, changed);
+}
+
+// Once the events already queued are handled
+static void schedule_flush(void) {
+  if (!s_flush_timer) s_flush_timer = app_timer_register(0, flush, NULL);
+}
+
+static void bt_timer_handler(void* data) {
+  s_bt_timer = NULL;
+  schedule_flush();
+}
+
+static void battery_event(BatteryChargeState state) {
+  TRACE_EVENT(TRACE_BATTERY, state.charge_percent | (state.is_charging ? 0x80 : 0));
+  s_latest.battery = state;
+  if (!battery_equal(state, s_shown.battery)) schedule_flush();
+}
+
+static void bt_event(bool connected) {
+  TRACE_EVENT(TRACE_BLUETOOTH, connected);
+  s_latest.connected = connected;
+  if (s_bt_timer) {
+    app_timer_cancel(s_bt_timer);
+    s_bt_timer = NULL;
+  }
+  // back to what is shown: a flap, or nothing new
+  if (connected == s_shown.connected) return;
+
+  if (connected) schedule_flush();
+  else s_bt_timer = app_timer_register(BT_DEBOUNCE_MS, bt_timer_handler, NULL);
+}
+
+void status_events_subscribe(StatusHandler handler) {
+  s_handler = handler;
+  s_shown.battery = s_latest.battery = battery_state_service_peek();
+  s_shown.connected = s_latest.connected = bluetooth_connection_service_peek();
+  battery_state_service_subscribe(battery_event);
+  bluetooth_connection_service_subscribe(bt_event);
+}
+
+void status_events_unsubscribe(void) {
+  battery_state_service_unsubscribe();
+  bluetooth_connection_service_unsubscribe();
+  if (s_flush_timer) app_timer_cancel(s_flush_timer);
+  if (s_bt_timer) app_timer_cancel(s_bt_timer);
+  s_flush_timer = s_bt_timer = NULL;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "pebble.h"
+
+/*
+ * Coalesces the battery and Bluetooth service events before they reach the
+ * app: updates that change nothing are dropped, a disconnection is only
+ * passed on once it lasted BT_DEBOUNCE_MS (settings.h), so a flapping
+ * connection neither blinks the icon nor vibrates, and the changes of one
+ * event loop turn are handed over together, for a single redraw.
+ */
+typedef struct {
+  BatteryChargeState battery;
+  bool connected;
+} StatusState;
+
+#define STATUS_BATTERY (1 << 0)
+#define STATUS_BLUETOOTH (1 << 1)
+
+// Gets the state and the STATUS_* mask of what changed since the last call
+typedef void (*StatusHandler)(const StatusState* state, int changed);
+
+// Subscribes to both services. The current state is taken as already shown,
+// handler is only called for changes from there.
+void status_events_subscribe(StatusHandler handler);
+void status_events_unsubscribe(void);
@@ -0,0 +1,29 @@
+#include "status_icons.h"
+
+// Layout printed by tools/gen_status_atlas.py
+static const GRect STATUS_ICON_RECTS[STATUS_ICON_COUNT] = {
+  { { 0, 0 }, { 11, 20 } },   // bluetooth_on.png
+  { { 16, 0 }, { 11, 20 } },  // bluetooth_off.png
+  { { 32, 0 }, { 12, 18 } },  // charging.png
+};
+
+static GBitmap* s_atlas;
+static GBitmap* s_views[STATUS_ICON_COUNT];
+
+GBitmap* status_icon(StatusIcon icon) {
+  if (s_views[icon]) return s_views[icon];
+
+  if (!s_atlas) s_atlas = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_STATUS_ICONS);
+  if (!s_atlas) return NULL;
+  s_views[icon] = gbitmap_create_as_sub_bitmap(s_atlas, STATUS_ICON_RECTS[icon]);
+  return s_views[icon];
+}
+
+void status_icons_unload(void) {
+  for (int i = 0; i < STATUS_ICON_COUNT; i++) {
+    if (s_views[i]) gbitmap_destroy(s_views[i]);
+    s_views[i] = NULL;
+  }
+  if (s_atlas) gbitmap_destroy(s_atlas);
+  s_atlas = NULL;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "pebble.h"
+
+/*
+ * The status icons share one atlas resource (STATUS_ICONS, packed by
+ * tools/gen_status_atlas.py). The atlas is decoded when the first icon is
+ * asked for, and each icon is a gbitmap_create_as_sub_bitmap() view of it,
+ * made on first use: one bitmap and one resource read for all the icons.
+ */
+typedef enum {
+  STATUS_ICON_BT_ON,
+  STATUS_ICON_BT_OFF,
+  STATUS_ICON_CHARGING,
+  STATUS_ICON_COUNT
+} StatusIcon;
+
+// View of icon, valid until status_icons_unload(), NULL if out of memory
+GBitmap* status_icon(StatusIcon icon);
+
+// Destroys the views and the atlas
+void status_icons_unload(void);
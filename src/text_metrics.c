@@ -0,0 +1,54 @@
+#include "text_metrics.h"
+
+// Enough for the phrases, battery levels and date of a day
+#define TEXT_METRICS_SLOTS 32
+// Longest text cached, with its NUL: the longest date, "Donnerstag 28.
+// März", takes 20 bytes, and 22 makes a slot 32 bytes on the watch
+#define TEXT_METRICS_TEXT_SIZE 22
+
+typedef struct {
+  uint32_t hash;
+  GFont font;
+  int16_t width;
+  char text[TEXT_METRICS_TEXT_SIZE];
+} TextMetrics;
+
+static TextMetrics s_metrics[TEXT_METRICS_SLOTS];
+static int s_next_slot;  // replaced next once every slot is used
+
+// FNV-1a, and the length of text in len
+static uint32_t text_hash(const char* text, size_t* len) {
+  uint32_t hash = 2166136261u;
+  const char* p = text;
+  while (*p) hash = (hash ^ (uint8_t)*p++) * 16777619u;
+  *len = p - text;
+  return hash;
+}
+
+int16_t text_width(const char* text, GFont font) {
+  size_t len;
+  uint32_t hash = text_hash(text, &len);
+  for (int i = 0; i < TEXT_METRICS_SLOTS; i++) {
+    TextMetrics* m = &s_metrics[i];
+    if (m->hash == hash && m->font == font && strcmp(m->text, text) == 0) return m->width;
+  }
+
+  GSize size = graphics_text_layout_get_content_size(text, font, GRect(0, 0, 1000, 100),
+                                                     GTextOverflowModeTrailingEllipsis,
+                                                     GTextAlignmentLeft);
+  // texts too long for a slot are measured each time
+  if (len < TEXT_METRICS_TEXT_SIZE) {
+    TextMetrics* m = &s_metrics[s_next_slot];
+    s_next_slot = (s_next_slot + 1) % TEXT_METRICS_SLOTS;
+    m->hash = hash;
+    m->font = font;
+    m->width = size.w;
+    memcpy(m->text, text, len + 1);
+  }
+  return size.w;
+}
+
+void text_metrics_reset(void) {
+  memset(s_metrics, 0, sizeof(s_metrics));
+  s_next_slot = 0;
+}
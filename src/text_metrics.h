@@ -0,0 +1,16 @@
+#pragma once
+
+#include "pebble.h"
+
+/*
+ * Text widths measured once per (text, font): the app draws a small set of
+ * strings (phrases, battery levels, dates), so after the first time a
+ * width is a cache lookup instead of a text layout. Entries keep a copy of
+ * the text, so buffers whose content changes are measured again.
+ */
+
+// Width in pixels of text drawn on one line in font
+int16_t text_width(const char* text, GFont font);
+
+// Forgets every width, for when fonts are unloaded
+void text_metrics_reset(void);
@@ -0,0 +1,50 @@
+#include "trace.h"
+
+#if TRACE_EVENTS
+
+static const char* const KIND_NAMES[TRACE_KIND_COUNT] = {
+  "tick", "anim start", "anim stop", "battery", "bluetooth"
+};
+
+const char* trace_kind_name(TraceKind kind) {
+  return kind < TRACE_KIND_COUNT ? KIND_NAMES[kind] : "?";
+}
+
+static TraceEvent s_events[TRACE_EVENTS];
+static uint32_t s_count;  // recorded so far, s_events[s_count % TRACE_EVENTS] is the next
+
+void trace_event(TraceKind kind, uint8_t arg) {
+  TraceEvent* event = &s_events[s_count++ % TRACE_EVENTS];
+  time_t seconds;
+  event->ms = time_ms(&seconds, NULL);
+  event->seconds = seconds;
+  event->kind = kind;
+  event->arg = arg;
+}
+
+int trace_read(TraceEvent* events, int max) {
+  int count = s_count < TRACE_EVENTS ? s_count : TRACE_EVENTS;
+  if (count > max) count = max;
+  for (int i = 0; i < count; i++) events[i] = s_events[(s_count - count + i) % TRACE_EVENTS];
+  return count;
+}
+
+void trace_dump(void) {
+  int count = s_count < TRACE_EVENTS ? s_count : TRACE_EVENTS;
+  for (int i = 0; i < count; i++) {
+    TraceEvent* event = &s_events[(s_count - count + i) % TRACE_EVENTS];
+    APP_LOG(APP_LOG_LEVEL_INFO, "%lu.%03u %s %u", (unsigned long)event->seconds, event->ms,
+            trace_kind_name(event->kind), event->arg);
+  }
+}
+
+#else
+
+int trace_read(TraceEvent* events, int max) {
+  return 0;
+}
+
+void trace_dump(void) {
+}
+
+#endif
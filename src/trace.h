@@ -0,0 +1,86 @@
+#pragma once
+
+#include "pebble.h"
+#include "settings.h"
+
+/*
+ * Tracing with no cost in release builds.
+ *
+ * TRACE_ERROR() ... TRACE_VERBOSE() are APP_LOG() calls kept only up to
+ * TRACE_LEVEL (settings.h); the others are compiled out with their
+ * arguments.
+ *
+ * TRACE_EVENT() records a binary event in a ring of the last TRACE_EVENTS
+ * events, timestamped, without formatting anything; with TRACE_EVENTS at
+ * 0 it compiles to nothing. trace_dump() logs the ring, or a harness reads
+ * it with trace_read().
+ */
+
+#define TRACE_LEVEL_NONE 0
+#define TRACE_LEVEL_ERROR 1
+#define TRACE_LEVEL_WARNING 50
+#define TRACE_LEVEL_INFO 100
+#define TRACE_LEVEL_DEBUG 200
+#define TRACE_LEVEL_VERBOSE 255
+
+#define TRACE_NOTHING(fmt, ...) do {} while (0)
+
+#if TRACE_LEVEL >= TRACE_LEVEL_ERROR
+#define TRACE_ERROR(fmt, ...) APP_LOG(APP_LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define TRACE_ERROR TRACE_NOTHING
+#endif
+#if TRACE_LEVEL >= TRACE_LEVEL_WARNING
+#define TRACE_WARNING(fmt, ...) APP_LOG(APP_LOG_LEVEL_WARNING, fmt, ##__VA_ARGS__)
+#else
+#define TRACE_WARNING TRACE_NOTHING
+#endif
+#if TRACE_LEVEL >= TRACE_LEVEL_INFO
+#define TRACE_INFO(fmt, ...) APP_LOG(APP_LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define TRACE_INFO TRACE_NOTHING
+#endif
+#if TRACE_LEVEL >= TRACE_LEVEL_DEBUG
+#define TRACE_DEBUG(fmt, ...) APP_LOG(APP_LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define TRACE_DEBUG TRACE_NOTHING
+#endif
+#if TRACE_LEVEL >= TRACE_LEVEL_VERBOSE
+#define TRACE_VERBOSE(fmt, ...) APP_LOG(APP_LOG_LEVEL_DEBUG_VERBOSE, fmt, ##__VA_ARGS__)
+#else
+#define TRACE_VERBOSE TRACE_NOTHING
+#endif
+
+typedef enum {
+  TRACE_TICK,           // arg: minute
+  TRACE_ANIM_START,     // arg: AnimPolicy mode
+  TRACE_ANIM_STOP,      // arg: finished
+  TRACE_BATTERY,        // arg: percent, | 0x80 when charging
+  TRACE_BLUETOOTH,      // arg: connected
+  TRACE_KIND_COUNT,
+} TraceKind;
+
+typedef struct {
+  uint32_t seconds;
+  uint16_t ms;
+  uint8_t kind;
+  uint8_t arg;
+} TraceEvent;
+
+#if TRACE_EVENTS
+#define TRACE_EVENT(kind, arg) trace_event((kind), (arg))
+void trace_event(TraceKind kind, uint8_t arg);
+#else
+#define TRACE_EVENT(kind, arg) do {} while (0)
+#endif
+
+// Copies the last events, oldest first, and returns their count
+int trace_read(TraceEvent* events, int max);
+
+// Logs the events, oldest first
+void trace_dump(void);
+
+#if TRACE_EVENTS
+// Name of an event kind, for the logs
+const char* trace_kind_name(TraceKind kind);
+#endif
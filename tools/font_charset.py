@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Character set of the custom time fonts.
+#
+# The Domestic Manners fonts only ever draw the fuzzy time phrases, so their
+# resources are limited to the characters of the phrases of every locale
+# through the characterRegex of each font entry in appinfo.json.
+#
+# usage: python tools/font_charset.py                   print the regex
+#        python tools/font_charset.py --chars           print the characters
+#        python tools/font_charset.py --check appinfo.json
+#        python tools/font_charset.py --update appinfo.json
+
+from __future__ import print_function
+import json
+import re
+import sys
+
+import gen_fuzzy_table
+
+try:
+  unichr
+except NameError:
+  unichr = chr
+
+# Last codepoint looked at when checking what a regex lets through
+MAX_CODEPOINT = 0x2FF
+
+
+def charset():
+  chars = set()
+  for code, locale in gen_fuzzy_table.LOCALES:
+    pool, table = gen_fuzzy_table.build_table(locale)
+    chars.update("".join(pool))
+  return sorted(chars)
+
+
+def emit(text):
+  """print(), as UTF-8 whatever the console or pipe encoding."""
+  getattr(sys.stdout, "buffer", sys.stdout).write((text + "\n").encode("utf-8"))
+
+
+def char_regex(chars):
+  def esc(c):
+    return "\\" + c if c in "\\]^-" else c
+
+  out, i = [], 0
+  while i < len(chars):
+    j = i
+    while j + 1 < len(chars) and ord(chars[j + 1]) == ord(chars[j]) + 1: j += 1
+    if j - i >= 2: out.append(esc(chars[i]) + "-" + esc(chars[j]))
+    else: out.extend(esc(c) for c in chars[i:j + 1])
+    i = j + 1
+  return "[" + "".join(out) + "]"
+
+
+def matched(regex):
+  r = re.compile(regex)
+  return [unichr(c) for c in range(0x20, MAX_CODEPOINT + 1) if r.match(unichr(c))]
+
+
+def font_entries(appinfo):
+  return [r for r in appinfo["resources"]["media"] if r["type"] == "font"]
+
+
+def main(argv):
+  chars = charset()
+  regex = char_regex(chars)
+  if len(argv) < 2:
+    emit(regex)
+    return 0
+  if argv[1] == "--chars":
+    emit("".join(chars))
+    return 0
+
+  mode, path = argv[1], argv[2]
+  with open(path) as f: appinfo = json.load(f)
+
+  if mode == "--update":
+    for font in font_entries(appinfo): font["characterRegex"] = regex
+    with open(path, "w") as f:
+      json.dump(appinfo, f, indent=4, sort_keys=True, separators=(",", ": "))
+      f.write("\n")
+    return 0
+
+  status = 0
+  for font in font_entries(appinfo):
+    have = font.get("characterRegex")
+    if have is None:
+      print("%s: no characterRegex, run tools/font_charset.py --update %s" % (font["name"], path))
+      status = 1
+      continue
+    got = matched(have)
+    missing = [c for c in chars if c not in got]
+    extra = [c for c in got if c not in chars]
+    emit("%s: %s, %d glyphs (%d needed)" % (font["name"], have, len(got), len(chars)))
+    if missing:
+      print("  missing: %r, run tools/font_charset.py --update %s" % ("".join(missing), path))
+      status = 1
+    if extra:
+      print("  unused: %r" % "".join(extra))
+  return status
+
+
+if __name__ == "__main__":
+  sys.exit(main(sys.argv))
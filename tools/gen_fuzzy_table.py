@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Generates the packed fuzzy time locales read by src/french_time.c.
+#
+# The rules of each locale (tools/locales/) are evaluated for every minute
+# of the day, then folded into a (hour, minute bucket) table of indexes into
+# a string pool, so the watch only does a lookup on each tick. Each locale
+# is packed into a raw resource, resources/data/locale_<code>.bin:
+#
+#   uint8_t  version, hours, buckets, next_hour_minute
+#   uint16_t phrase_base      first PHRASE_BITMAPS id of the locale
+#   uint16_t strings          offset of the string offsets below
+#   uint8_t  string_count, date_format
+#   uint8_t  days[7], months[12]
+#   uint8_t  bucket_of_minute[60], minutes_to_next_bucket[60]
+#   uint8_t  table[hours][buckets][3]     line1, line2, line3
+#   uint16_t string offsets[string_count] (2 byte aligned)
+#   NUL terminated UTF-8 strings
+#
+# Integers are little endian, offsets from the start of the resource and
+# every field other than the table is a string index. String 0 is "".
+#
+# usage: python tools/gen_fuzzy_table.py --update resources/data
+#        python tools/gen_fuzzy_table.py --check resources/data
+#        python tools/gen_fuzzy_table.py --phrases > phrases.txt
+
+from __future__ import print_function
+import os
+import struct
+import sys
+
+from locales import LOCALES
+
+LOCALE_VERSION = 1
+HEADER_FORMAT = "<BBBBHHBB"
+
+# Pixel height of the font each line is drawn with (see main.c)
+LINE_FONT_SIZES = [48, 36, 36]
+
+
+def bucket_of(locale, minute):
+  return max(b for b, edge in enumerate(locale.BUCKET_EDGES) if minute >= edge)
+
+
+def minutes_to_next_bucket(locale, minute):
+  return min([edge for edge in locale.BUCKET_EDGES if edge > minute] + [60]) - minute
+
+
+def build_table(locale):
+  """Returns the string pool and the [hour][bucket] table of pool indexes."""
+  nbuckets = len(locale.BUCKET_EDGES)
+  pool = [""]
+  table = [[None] * nbuckets for _ in range(13)]
+
+  def intern(s):
+    if s not in pool: pool.append(s)
+    return pool.index(s)
+
+  for hour in range(24):
+    for minute in range(60):
+      key_hour, lines = locale.fuzzy(hour, minute)
+      ids = [intern(s) for s in lines]
+      bucket = bucket_of(locale, minute)
+      cell = table[key_hour][bucket]
+      if cell is not None and cell != ids:
+        sys.exit("gen_fuzzy_table: %s bucket %d is not uniform at %02d:%02d" % (locale.__name__, bucket, hour, minute))
+      table[key_hour][bucket] = ids
+
+  return pool, table
+
+
+def phrase_bases():
+  """First PHRASE_BITMAPS id of each locale: pools follow each other."""
+  bases, base = [], 0
+  for code, locale in LOCALES:
+    bases.append(base)
+    base += len(build_table(locale)[0])
+  return bases
+
+
+def pack(locale, phrase_base):
+  pool, table = build_table(locale)
+  nbuckets = len(locale.BUCKET_EDGES)
+  date_words = list(locale.DAYS) + list(locale.MONTHS) + [locale.DATE_FORMAT]
+  strings = pool + [s for s in date_words if s not in pool]
+  assert len(strings) < 256
+
+  body = bytearray()
+  body += bytearray(strings.index(s) for s in locale.DAYS)
+  body += bytearray(strings.index(s) for s in locale.MONTHS)
+  body += bytearray(bucket_of(locale, m) for m in range(60))
+  body += bytearray(minutes_to_next_bucket(locale, m) for m in range(60))
+  for hour in table:
+    for cell in hour:
+      body += bytearray(cell or (0, 0, 0))
+
+  offsets_at = struct.calcsize(HEADER_FORMAT) + len(body)
+  offsets_at += offsets_at & 1
+  data = bytearray()
+  offset = offsets_at + 2 * len(strings)
+  for s in strings:
+    data += bytearray(s.encode("utf-8") + b"\0")
+  header = struct.pack(HEADER_FORMAT, LOCALE_VERSION, len(table), nbuckets, locale.NEXT_HOUR_MINUTE,
+                       phrase_base, offsets_at, len(strings), strings.index(locale.DATE_FORMAT))
+
+  out = bytearray(header) + body
+  out += bytearray(offsets_at - len(out))
+  for s in strings:
+    out += struct.pack("<H", offset)
+    offset += len(s.encode("utf-8")) + 1
+  return bytes(out + data)
+
+
+def print_phrases():
+  """Lists '<PHRASE_BITMAPS id> <font size> <phrase>' for every phrase
+  drawn, as input of host/render_phrases.c."""
+  for (code, locale), base in zip(LOCALES, phrase_bases()):
+    pool, table = build_table(locale)
+    drawn = set()
+    for hour in table:
+      for cell in hour:
+        for line, index in enumerate(cell or ()):
+          if index: drawn.add((index, LINE_FONT_SIZES[line]))
+    for index, size in sorted(drawn):
+      line = "%d %d %s" % (base + index, size, pool[index])
+      getattr(sys.stdout, "buffer", sys.stdout).write((line + "\n").encode("utf-8"))
+
+
+def main(argv):
+  if argv[1:] == ["--phrases"]:
+    print_phrases()
+    return 0
+  if len(argv) != 3 or argv[1] not in ("--check", "--update"):
+    print(__doc__ or "usage: gen_fuzzy_table.py --check|--update DIR | --phrases", file=sys.stderr)
+    return 2
+
+  status = 0
+  for (code, locale), base in zip(LOCALES, phrase_bases()):
+    path = os.path.join(argv[2], "locale_%s.bin" % code)
+    data = pack(locale, base)
+    if argv[1] == "--update":
+      with open(path, "wb") as f: f.write(data)
+      continue
+    with open(path, "rb") as f: current = f.read()
+    if current != data:
+      print("%s is stale, run tools/gen_fuzzy_table.py --update %s" % (path, argv[2]))
+      status = 1
+    else:
+      print("%s: %d bytes" % (path, len(data)))
+  return status
+
+
+if __name__ == "__main__":
+  sys.exit(main(sys.argv))
@@ -0,0 +1,123 @@
+#!/usr/bin/env python
+#
+# Packs the status icons into one atlas image, resources/images/status_icons.png
+# (the STATUS_ICONS resource). The watchface decodes the atlas once and
+# shows each icon through a gbitmap_create_as_sub_bitmap() view, see
+# src/status_icons.c, whose STATUS_ICON_RECTS must match the layout printed
+# here.
+#
+# The icons are laid out left to right, top aligned, each starting on a
+# byte boundary of the 1 bit bitmap. Pixels are copied as they are (RGBA,
+# icons without alpha are opaque), the space around the icons is
+# transparent white.
+#
+# usage: python tools/gen_status_atlas.py --update resources/images
+#        python tools/gen_status_atlas.py --check resources/images
+
+from __future__ import print_function
+import os
+import struct
+import sys
+import zlib
+
+# In the StatusIcon order of src/status_icons.h
+ICONS = ["bluetooth_on.png", "bluetooth_off.png", "charging.png"]
+ATLAS = "status_icons.png"
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+
+
+def paeth(a, b, c):
+  p = a + b - c
+  pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+  if pa <= pb and pa <= pc: return a
+  return b if pb <= pc else c
+
+
+def read_png(path):
+  """Returns (width, height, rows of RGBA bytearrays) of an 8 bit RGB or
+  RGBA, non interlaced PNG."""
+  with open(path, "rb") as f: data = f.read()
+  if data[:8] != PNG_SIGNATURE: sys.exit("%s: not a PNG" % path)
+  pos, idat = 8, b""
+  while pos < len(data):
+    length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+    chunk = data[pos + 8:pos + 8 + length]
+    pos += 12 + length
+    if kind == b"IHDR":
+      width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+    elif kind == b"IDAT":
+      idat += chunk
+  if depth != 8 or color not in (2, 6) or interlace:
+    sys.exit("%s: only 8 bit RGB or RGBA, non interlaced PNGs are supported" % path)
+
+  bpp = 3 if color == 2 else 4
+  stride = width * bpp
+  raw = bytearray(zlib.decompress(idat))
+  rows, prev = [], bytearray(stride)
+  for y in range(height):
+    kind = raw[y * (stride + 1)]
+    line = raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)]
+    for x in range(stride):
+      a = line[x - bpp] if x >= bpp else 0
+      b = prev[x]
+      c = prev[x - bpp] if x >= bpp else 0
+      line[x] = (line[x] + (0, a, b, (a + b) // 2, paeth(a, b, c))[kind]) & 0xFF
+    prev = line
+    if bpp == 3:
+      line = bytearray(b"".join(bytes(line[x:x + 3]) + b"\xff" for x in range(0, stride, 3)))
+    rows.append(line)
+  return width, height, rows
+
+
+def png_chunk(kind, data):
+  return struct.pack(">I", len(data)) + kind + data + struct.pack(">I", zlib.crc32(kind + data) & 0xFFFFFFFF)
+
+
+def write_png(width, height, rows):
+  raw = b"".join(b"\0" + bytes(row) for row in rows)
+  return (PNG_SIGNATURE +
+          png_chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 6, 0, 0, 0)) +
+          png_chunk(b"IDAT", zlib.compress(raw, 9)) +
+          png_chunk(b"IEND", b""))
+
+
+def build_atlas(directory):
+  """Returns the atlas PNG data and the (x, y, w, h) rect of each icon."""
+  icons = [read_png(os.path.join(directory, name)) for name in ICONS]
+  rects, x = [], 0
+  for width, height, rows in icons:
+    rects.append((x, 0, width, height))
+    x += (width + 7) // 8 * 8
+  atlas_w = rects[-1][0] + rects[-1][2]
+  atlas_h = max(height for width, height, rows in icons)
+
+  atlas = [bytearray(b"\xff\xff\xff\x00" * atlas_w) for _ in range(atlas_h)]
+  for (x, y, w, h), (width, height, rows) in zip(rects, icons):
+    for row in range(h):
+      atlas[y + row][x * 4:(x + w) * 4] = rows[row]
+  return write_png(atlas_w, atlas_h, atlas), rects
+
+
+def main(argv):
+  if len(argv) != 3 or argv[1] not in ("--check", "--update"):
+    print("usage: gen_status_atlas.py --check|--update DIR", file=sys.stderr)
+    return 2
+
+  data, rects = build_atlas(argv[2])
+  path = os.path.join(argv[2], ATLAS)
+  for name, rect in zip(ICONS, rects):
+    print("%-18s GRect(%d, %d, %d, %d)" % (name, rect[0], rect[1], rect[2], rect[3]))
+  if argv[1] == "--update":
+    with open(path, "wb") as f: f.write(data)
+    return 0
+
+  with open(path, "rb") as f: current = f.read()
+  if current != data:
+    print("%s is stale, run tools/gen_status_atlas.py --update %s" % (path, argv[2]))
+    return 1
+  return 0
+
+
+if __name__ == "__main__":
+  sys.exit(main(sys.argv))
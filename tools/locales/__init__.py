@@ -0,0 +1,26 @@
+# -*- coding: utf-8 -*-
+#
+# Fuzzy time locales, one module per language. Each one defines:
+#
+#   NEXT_HOUR_MINUTE  minute from which the phrase names the next hour
+#   BUCKET_EDGES      first minute of each bucket of identical phrases
+#   DAYS, MONTHS      date words, Sunday and January first
+#   DATE_FORMAT       bottom bar date: %A day, %d day of month, %B month
+#                     (the " - " before it ends the time, hidden in low wake)
+#   fuzzy(h, m)       -> (named hour 0..12, (line1, line2, line3))
+#
+# The order of LOCALES is the FuzzyLocaleId order of src/french_time.h.
+
+
+
+def named_hour(hours, minutes, next_hour_minute):
+  """Hour 0..12 named by the phrase at hours:minutes (0 is midnight)."""
+  if minutes >= next_hour_minute: hours += 1
+  if hours >= 24: hours = 0
+  if hours > 12: hours -= 12
+  return hours
+
+
+from . import fr, en, de
+
+LOCALES = [("fr", fr), ("en", en), ("de", de)]
@@ -0,0 +1,49 @@
+# -*- coding: utf-8 -*-
+#
+# German: "zehn / nach / acht", "fünf / vor halb / neun", "halb / neun".
+
+from __future__ import unicode_literals
+from . import named_hour
+
+HOURS = [
+  "zwölf", "eins", "zwei", "drei", "vier", "fünf", "sechs",
+  "sieben", "acht", "neun", "zehn", "elf", "zwölf"
+]
+
+# "halb neun" is half past eight
+NEXT_HOUR_MINUTE = 23
+
+BUCKET_EDGES = [0, 1, 3, 8, 13, 18, 23, 28, 33, 38, 43, 48, 53, 58]
+
+DAYS = ["Sonntag", "Montag", "Dienstag", "Mittwoch", "Donnerstag", "Freitag", "Samstag"]
+
+MONTHS = [
+  "Jan.", "Feb.", "März", "April", "Mai", "Juni",
+  "Juli", "Aug.", "Sep.", "Okt.", "Nov.", "Dez."
+]
+
+DATE_FORMAT = "%A %d. %B"
+
+# (line1, line2) of each bucket after the first two, the hour goes on line3
+NACH_VOR = [
+  ("fünf", "nach"), ("zehn", "nach"), ("viertel", "nach"), ("zwanzig", "nach"),
+  ("fünf", "vor halb"), ("halb", None), ("fünf", "nach halb"), ("zwanzig", "vor"),
+  ("viertel", "vor"), ("zehn", "vor"), ("fünf", "vor"),
+]
+
+
+def fuzzy(hours, minutes):
+  hours = named_hour(hours, minutes, NEXT_HOUR_MINUTE)
+  hour = HOURS[hours]
+
+  if minutes == 0:
+    # "ein Uhr", but "fünf nach eins"
+    lines = ("ein" if hours == 1 else hour, "Uhr", "")
+  elif minutes < 3:
+    lines = ("kurz", "nach", hour)
+  elif minutes < 58:
+    line1, line2 = NACH_VOR[(minutes - 3) // 5]
+    lines = (line1, line2, hour) if line2 else (line1, hour, "")
+  else:
+    lines = ("kurz", "vor", hour)
+  return hours, lines
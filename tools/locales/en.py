@@ -0,0 +1,47 @@
+# -*- coding: utf-8 -*-
+#
+# English: "ten / past / eight", "quarter / to / nine".
+
+from __future__ import unicode_literals
+from . import named_hour
+
+HOURS = [
+  "midnight", "one", "two", "three", "four", "five", "six",
+  "seven", "eight", "nine", "ten", "eleven", "noon"
+]
+
+NEXT_HOUR_MINUTE = 33
+
+BUCKET_EDGES = [0, 1, 3, 8, 13, 18, 23, 28, 33, 38, 43, 48, 53, 58]
+
+DAYS = ["Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"]
+
+MONTHS = [
+  "Jan.", "Feb.", "March", "April", "May", "June",
+  "July", "Aug.", "Sep.", "Oct.", "Nov.", "Dec."
+]
+
+DATE_FORMAT = "%A %B %d"
+
+# (line1, line2) of each bucket after the first two, the hour goes on line3
+PAST_TO = [
+  ("five", "past"), ("ten", "past"), ("quarter", "past"), ("twenty", "past"),
+  ("twenty", "five past"), ("half", "past"), ("twenty", "five to"), ("twenty", "to"),
+  ("quarter", "to"), ("ten", "to"), ("five", "to"),
+]
+
+
+def fuzzy(hours, minutes):
+  hours = named_hour(hours, minutes, NEXT_HOUR_MINUTE)
+  hour = HOURS[hours]
+  named = hours > 0 and hours < 12
+
+  if minutes == 0:
+    lines = (hour, "o'clock" if named else "", "")
+  elif minutes < 3:
+    lines = ("just", "after", hour)
+  elif minutes < 58:
+    lines = PAST_TO[(minutes - 3) // 5] + (hour,)
+  else:
+    lines = ("almost", hour, "")
+  return hours, lines
@@ -0,0 +1,84 @@
+# -*- coding: utf-8 -*-
+#
+# French, a straight port of the historical strcat cascade of fuzzy_time().
+
+from __future__ import unicode_literals
+
+STR_HEURE = "heure"
+STR_H = " h."
+STR_H2 = "h. "
+STR_MOINS = "moins"
+STR_M = "- "
+
+HEURES = [
+  "minuit", "une", "deux", "trois", "quatre", "cinq", "six",
+  "sept", "huit", "neuf", "dix", "onze", "midi"
+]
+
+MINS = [
+  "pile !", "cinq", "dix", "et quart", "vingt", "et demi", "le quart", "..."
+]
+
+NEXT_HOUR_MINUTE = 33
+
+# Minute 0 ("pile !") has a bucket of its own, every other bucket lasts
+# until the next edge.
+BUCKET_EDGES = [0, 1, 3, 8, 13, 18, 23, 28, 33, 38, 43, 48, 53, 58]
+
+DAYS = ["Dimanche", "Lundi", "Mardi", "Mercredi", "Jeudi", "Vendredi", "Samedi"]
+
+MONTHS = [
+  "Jan.", "Fév.", "Mars", "Avril", "Mai", "Juin",
+  "Juil.", "Août", "Sep.", "Oct.", "Nov.", "Déc."
+]
+
+DATE_FORMAT = "%A %d %B"
+
+
+def fuzzy(hours, minutes):
+  line1 = line2 = line3 = ""
+
+  if minutes >= NEXT_HOUR_MINUTE: hours += 1
+  if hours >= 24: hours = 0
+  if hours > 12: hours -= 12
+
+  line1 += HEURES[hours]
+  named = hours > 0 and hours < 12
+  heures = STR_HEURE + ("s" if hours > 1 else "")
+
+  def h_suffix(line1, line2):
+    if named:
+      if hours == 4: line2 += STR_H2
+      else: line1 += STR_H
+    return line1, line2
+
+  if minutes < 3:
+    if named: line2 += heures
+    if minutes == 0:
+      if named: line3 += MINS[0]
+      else: line2 += MINS[0]
+  elif minutes < 23 or (minutes >= 28 and minutes < 33):
+    m = MINS[1 + (minutes - 3) // 5] if minutes < 23 else MINS[5]
+    if named:
+      line2 += heures
+      line3 += m
+    else:
+      line2 += m
+  elif minutes < 28:
+    line1, line2 = h_suffix(line1, line2)
+    line2 += MINS[4]
+    line3 += MINS[1]
+  elif minutes < 58:
+    line1, line2 = h_suffix(line1, line2)
+    if minutes < 38:
+      line2 += STR_M + MINS[4]
+      line3 += MINS[1]
+    else:
+      line2 += STR_MOINS
+      line3 += MINS[[4, 6, 2, 1][(minutes - 38) // 5]]
+  else:
+    line1 = MINS[7]
+    line2 += HEURES[hours]
+    if named: line3 += heures
+
+  return hours, (line1, line2, line3)
@@ -0,0 +1,66 @@
+#!/usr/bin/env python
+#
+# Per-symbol .text/.data/.bss breakdown of the app binary, checked against
+# memory budgets. The whole app binary is loaded in RAM on the watch, so
+# code and constants count as much as variables.
+#
+# usage: python tools/mem_report.py NM ELF REPORT [--text N] [--data N] [--bss N]
+#
+# Writes the report to REPORT, prints the totals and exits with 1 when a
+# section goes over its budget.
+
+from __future__ import print_function
+import subprocess
+import sys
+
+# nm symbol types -> section
+SECTIONS = [
+  ("text", "tTwWrR"),  # code and read-only data
+  ("data", "dDgG"),
+  ("bss", "bBsScC"),
+]
+
+
+def read_symbols(nm, elf):
+  out = subprocess.check_output([nm, "--size-sort", "-S", "--radix=d", elf])
+  symbols = dict((name, []) for name, _ in SECTIONS)
+  for line in out.decode("ascii", "replace").splitlines():
+    fields = line.split()
+    if len(fields) != 4: continue
+    size, kind, name = int(fields[1]), fields[2], fields[3]
+    for section, kinds in SECTIONS:
+      if kind in kinds: symbols[section].append((size, name))
+  return symbols
+
+
+def main(argv):
+  if len(argv) < 4:
+    sys.exit("usage: mem_report.py NM ELF REPORT [--text N] [--data N] [--bss N]")
+  nm, elf, report_path = argv[1:4]
+  budgets = {}
+  args = argv[4:]
+  for i in range(0, len(args) - 1, 2):
+    budgets[args[i].lstrip("-")] = int(args[i + 1])
+
+  symbols = read_symbols(nm, elf)
+  lines, failed = [], []
+
+  for section, _ in SECTIONS:
+    total = sum(size for size, _ in symbols[section])
+    budget = budgets.get(section)
+    lines.append(".%s: %d bytes%s" % (section, total, " (budget %d)" % budget if budget else ""))
+    for size, name in sorted(symbols[section], reverse=True):
+      lines.append("  %6d  %s" % (size, name))
+    lines.append("")
+    print("memory: .%-4s %6d bytes%s" % (section, total, " / %d" % budget if budget else ""))
+    if budget and total > budget: failed.append(".%s is %d bytes, over its %d bytes budget" % (section, total, budget))
+
+  with open(report_path, "w") as f:
+    f.write("\n".join(lines))
+
+  for message in failed: print("memory: " + message, file=sys.stderr)
+  return 1 if failed else 0
+
+
+if __name__ == "__main__":
+  sys.exit(main(sys.argv))
@@ -0,0 +1,96 @@
+#!/usr/bin/env python
+#
+# Resources of the drawing mode set in src/settings.h.
+#
+# The text mode draws the fuzzy time with the custom fonts, the
+# PHRASE_BITMAPS mode with the phrase bitmaps (resources/data/phrases.bin)
+# of every locale, as the locale is a setting of the watch. Together they
+# are over the 96 KB of resources SDK 2 allows, so appinfo.json only
+# registers those of the mode set; the build checks it, and --update adds
+# or removes the entries after PHRASE_BITMAPS is changed. The host build,
+# which builds every mode, registers the resources of all of them.
+#
+# usage: python tools/mode_resources.py --check src/settings.h appinfo.json
+#        python tools/mode_resources.py --update src/settings.h appinfo.json
+
+from __future__ import print_function
+import json
+import os
+import re
+import sys
+
+import font_charset
+
+# SDK 2 limit on the resources of an app
+RESOURCES_BUDGET = 96 * 1024
+
+FONT_REGEX = font_charset.char_regex(font_charset.charset())
+
+# Entries of each mode, by PHRASE_BITMAPS value
+MODE_MEDIA = {
+  0: [{"characterRegex": FONT_REGEX, "file": "fonts/Domestic_Manners.ttf",
+       "name": "FONT_DOMESTIC_BOLD_SUBSET_36", "type": "font"},
+      {"characterRegex": FONT_REGEX, "file": "fonts/Domestic_Manners.ttf",
+       "name": "FONT_DOMESTIC_BOLD_SUBSET_48", "type": "font"}],
+  1: [{"file": "data/phrases.bin", "name": "PHRASE_BITMAPS", "type": "raw"}],
+}
+
+
+def phrase_bitmaps(settings_path):
+  with open(settings_path) as f:
+    m = re.search(r"^#define PHRASE_BITMAPS (\d+)", f.read(), re.M)
+  return int(m.group(1)) if m else 0
+
+
+def with_media(media, entries):
+  """media without the entries of any mode, then the given ones inserted
+  after the images. Entries already there are kept as they are."""
+  names = set(e["name"] for mode in MODE_MEDIA.values() for e in mode)
+  have = dict((e["name"], e) for e in media)
+  media = [e for e in media if e["name"] not in names]
+  at = max([i + 1 for i, e in enumerate(media) if e["type"] == "png"] or [0])
+  return media[:at] + [have.get(e["name"], dict(e)) for e in entries] + media[at:]
+
+
+def all_media(media):
+  """media with the resources of every mode, for the host build."""
+  return with_media(media, [e for mode in sorted(MODE_MEDIA) for e in MODE_MEDIA[mode]])
+
+
+def main(argv):
+  if len(argv) != 4 or argv[1] not in ("--check", "--update"):
+    print(__doc__ or "usage: mode_resources.py --check|--update SETTINGS APPINFO", file=sys.stderr)
+    return 2
+
+  mode = phrase_bitmaps(argv[2])
+  path = argv[3]
+  with open(path) as f: appinfo = json.load(f)
+  media = appinfo["resources"]["media"]
+  wanted = with_media(media, MODE_MEDIA.get(mode, MODE_MEDIA[1]))
+
+  if argv[1] == "--update":
+    appinfo["resources"]["media"] = wanted
+    with open(path, "w") as f:
+      json.dump(appinfo, f, indent=4, sort_keys=True, separators=(",", ": "))
+      f.write("\n")
+    return 0
+
+  have = [e["name"] for e in media]
+  if have != [e["name"] for e in wanted]:
+    print("%s does not match PHRASE_BITMAPS %d, run tools/mode_resources.py --update %s %s"
+          % (path, mode, argv[2], path))
+    return 1
+  print("PHRASE_BITMAPS %d: %s" % (mode, " ".join(have)))
+
+  # The raw resources are packaged as they are
+  resources = os.path.join(os.path.dirname(os.path.abspath(path)), "resources")
+  raw = sum(os.path.getsize(os.path.join(resources, e["file"])) for e in media if e["type"] == "raw")
+  print("raw resources: %d bytes (budget %d)" % (raw, RESOURCES_BUDGET))
+  if raw > RESOURCES_BUDGET:
+    print("raw resources over the %d bytes budget" % RESOURCES_BUDGET)
+    return 1
+  return 0
+
+
+if __name__ == "__main__":
+  sys.exit(main(sys.argv))